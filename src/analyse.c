@@ -0,0 +1,211 @@
+/*
+   libtimecode - discontinuity and dropout detection
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+
+#include "timecode/timecode_analyse.h"
+#include "internal.h"
+
+#define BLOCK 1024
+
+static const char * const anomaly_names[TIMECODE_ANOMALY_COUNT] = {
+	"repeat",
+	"drop",
+	"jump",
+	"dropframe",
+	"invalid",
+};
+
+const char *timecode_anomaly_name (const TimecodeAnomalyType type) {
+	if ((unsigned int)type >= TIMECODE_ANOMALY_COUNT) return NULL;
+	return anomaly_names[type];
+}
+
+/*****************************************************************************
+ * helpers
+ */
+
+typedef struct {
+	TimecodeAnalysis *a;
+	size_t a_runs;
+	size_t a_anomalies;
+	int64_t fps_i;
+	int64_t fpd;
+	int64_t max_drop;
+	int drop;
+	int in_run;   ///< the previous timecode is part of a run
+	size_t run;   ///< index of the current run
+} AnalyseState;
+
+static int grow(void **p, size_t *alloc, const size_t n, const size_t size) {
+	void *np;
+	size_t a;
+	if (n < *alloc) return 0;
+	a = *alloc ? *alloc * 2 : 64;
+	np = realloc(*p, a * size);
+	if (!np) return -1;
+	*p = np;
+	*alloc = a;
+	return 0;
+}
+
+static int run_start(AnalyseState * const s, const size_t index, const int64_t frame) {
+	TimecodeAnalysis * const a = s->a;
+	if (grow((void**)&a->runs, &s->a_runs, a->n_runs, sizeof(TimecodeRun))) return -1;
+	a->runs[a->n_runs].start = index;
+	a->runs[a->n_runs].length = 0;
+	a->runs[a->n_runs].frame = frame;
+	s->run = a->n_runs++;
+	s->in_run = 1;
+	return 0;
+}
+
+static void run_end(AnalyseState * const s, const size_t index) {
+	if (!s->in_run) return;
+	s->a->runs[s->run].length = index - s->a->runs[s->run].start;
+	s->in_run = 0;
+}
+
+static int anomaly(AnalyseState * const s, const size_t index, const TimecodeAnomalyType type, const int64_t delta) {
+	TimecodeAnalysis * const a = s->a;
+	if (grow((void**)&a->anomalies, &s->a_anomalies, a->n_anomalies, sizeof(TimecodeAnomaly))) return -1;
+	a->anomalies[a->n_anomalies].index = index;
+	a->anomalies[a->n_anomalies].type = type;
+	a->anomalies[a->n_anomalies].delta = delta;
+	++a->n_anomalies;
+	++a->count[type];
+	return 0;
+}
+
+/* 0: valid, 1: out of range, 2: label skipped by drop-frame */
+static inline int label_check(TimecodeTime const * const t, const int64_t fps_i, const int drop) {
+	if (   (uint32_t)t->hour >= 24 || (uint32_t)t->minute >= 60
+	    || (uint32_t)t->second >= 60 || (uint32_t)t->frame >= fps_i) {
+		return 1;
+	}
+	if (drop && t->second == 0 && t->frame < 2 && (t->minute % 10) != 0) {
+		return 2;
+	}
+	return 0;
+}
+
+/* classify timecode i, given frame numbers of i and i-1 */
+static int classify(AnalyseState * const s, TimecodeTime const * const t, const size_t i, const int64_t f, const int64_t prev) {
+	TimecodeTime const * const c = &t[i];
+	const int64_t d = f - prev;
+	TimecodeAnomalyType type;
+
+	switch (label_check(c, s->fps_i, s->drop)) {
+		case 1:
+			run_end(s, i);
+			return anomaly(s, i, TIMECODE_ANOMALY_INVALID, 0);
+		case 2:
+			run_end(s, i);
+			return anomaly(s, i, TIMECODE_ANOMALY_DROPFRAME, 0);
+		default:
+			break;
+	}
+
+	if (!s->in_run) {
+		return run_start(s, i, f);
+	}
+	if (d == 1 || d == 1 - s->fpd) {
+		return 0;
+	}
+
+	if (d == 0) {
+		type = TIMECODE_ANOMALY_REPEAT;
+	} else if (d == 3 && c->second == 0 && c->frame == 2 && t[i - 1].second == 59 && t[i - 1].frame == s->fps_i - 1) {
+		/* frames 0, 1 skipped, in non-drop-frame or at every 10th minute */
+		type = TIMECODE_ANOMALY_DROPFRAME;
+	} else if (d > 1 && d - 1 <= s->max_drop) {
+		type = TIMECODE_ANOMALY_DROP;
+	} else {
+		type = TIMECODE_ANOMALY_JUMP;
+	}
+	run_end(s, i);
+	if (anomaly(s, i, type, d - 1)) return -1;
+	return run_start(s, i, f);
+}
+
+/*****************************************************************************
+ * analyser
+ */
+
+TimecodeAnalysis *timecode_analyse (TimecodeTime const * const t, const size_t n, TimecodeRate const * const r, int64_t max_drop) {
+	AnalyseState s;
+	int64_t f[BLOCK];
+	int64_t prev = 0;
+	size_t b, i;
+
+	s.a = (TimecodeAnalysis*) calloc(1, sizeof(TimecodeAnalysis));
+	if (!s.a) return NULL;
+	s.a_runs = s.a_anomalies = 0;
+	s.fps_i = TC_FPS_I(r);
+	s.fpd = tc_frames_per_day(r);
+	s.max_drop = max_drop > 0 ? max_drop : s.fps_i;
+	s.drop = r->drop ? 1 : 0;
+	s.in_run = 0;
+	s.run = 0;
+
+	for (b = 0; b < n; b += BLOCK) {
+		const size_t m = n - b < BLOCK ? n - b : BLOCK;
+		TimecodeTime const * const tb = &t[b];
+		uint32_t bad = 0;
+		uint64_t nonseq = 0;
+
+		/* pack to frame numbers and check labels */
+		for (i = 0; i < m; ++i) {
+			f[i] = tc_time_to_frames(&tb[i], r);
+			bad |= label_check(&tb[i], s.fps_i, s.drop);
+		}
+		/* adjacent differences, all must be one */
+		for (i = 1; i < m; ++i) {
+			nonseq |= (uint64_t)(f[i] - f[i - 1] - 1);
+		}
+
+		if (!bad && !nonseq && s.in_run && f[0] - prev == 1) {
+			prev = f[m - 1];
+			continue;
+		}
+
+		for (i = 0; i < m; ++i) {
+			if (classify(&s, t, b + i, f[i], i > 0 ? f[i - 1] : prev)) {
+				timecode_analysis_free(s.a);
+				return NULL;
+			}
+		}
+		prev = f[m - 1];
+	}
+	run_end(&s, n);
+	return s.a;
+}
+
+void timecode_analysis_free (TimecodeAnalysis *a) {
+	if (!a) return;
+	free(a->runs);
+	free(a->anomalies);
+	free(a);
+}
@@ -0,0 +1,281 @@
+/*
+   libtimecode - compact binary timecode streams
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "timecode/timecode_bin.h"
+#include "timecode/timecode_rates.h"
+#include "internal.h"
+
+#define TOKEN_RUN_MAX  0x7f
+#define TOKEN_SHORT    0x80
+#define TOKEN_VARINT   0xc0
+
+static const uint8_t bin_magic[4] = { 'T', 'C', 'B', '1' };
+
+/*****************************************************************************
+ * helpers
+ */
+
+static inline int32_t bin_subframes(TimecodeRate const * const r) {
+	return r->subframes > 0 ? r->subframes : 1;
+}
+
+static inline int bin_has_date(TimecodeDate const * const d) {
+	return d->month > 0;
+}
+
+static inline int bin_same_rate(TimecodeRate const * const a, TimecodeRate const * const b) {
+	return a->num == b->num && a->den == b->den
+		&& (a->drop != 0) == (b->drop != 0) && a->subframes == b->subframes;
+}
+
+static inline uint64_t zigzag(const int64_t v) {
+	return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t unzigzag(const uint64_t v) {
+	return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline void put_le(uint8_t * const p, uint32_t v, const int n) {
+	int i;
+	for (i = 0; i < n; ++i, v >>= 8) p[i] = v & 0xff;
+}
+
+static inline uint32_t get_le(const uint8_t * const p, const int n) {
+	uint32_t v = 0;
+	int i;
+	for (i = n - 1; i >= 0; --i) v = (v << 8) | p[i];
+	return v;
+}
+
+/*****************************************************************************
+ * writer
+ */
+
+int timecode_bin_writer_init (TimecodeBinWriter * const w, uint8_t * const buf, const size_t size, Timecode const * const anchor) {
+	const TimecodeRateID id = timecode_rate_id(&anchor->r);
+	size_t pos = 0;
+
+	if (size < TIMECODE_BIN_HEADER_MAX) return -1;
+	if (anchor->r.num <= 0 || anchor->r.den <= 0 || anchor->r.subframes < 0) return -1;
+
+	memcpy(buf, bin_magic, 4);
+	pos = 4;
+	buf[pos++] = id;
+	if (id == TIMECODE_RATE_INVALID) {
+		put_le(&buf[pos], anchor->r.num, 4); pos += 4;
+		put_le(&buf[pos], anchor->r.den, 4); pos += 4;
+		buf[pos++] = anchor->r.drop ? 1 : 0;
+		put_le(&buf[pos], anchor->r.subframes, 4); pos += 4;
+	}
+	put_le(&buf[pos], (uint16_t)anchor->d.year, 2); pos += 2;
+	buf[pos++] = anchor->d.month;
+	buf[pos++] = anchor->d.day;
+	put_le(&buf[pos], (uint16_t)anchor->d.timezone, 2); pos += 2;
+
+	w->buf = buf;
+	w->size = size;
+	w->pos = pos;
+	w->run = 0;
+	w->expected = 0;
+	w->r = anchor->r;
+	if (bin_has_date(&anchor->d)) {
+		w->anchor = tc_days_from_civil(anchor->d.year, anchor->d.month, anchor->d.day);
+	} else {
+		w->anchor = INT64_MIN;
+	}
+	return 0;
+}
+
+void timecode_bin_writer_set_buffer (TimecodeBinWriter * const w, uint8_t * const buf, const size_t size) {
+	w->buf = buf;
+	w->size = size;
+	w->pos = 0;
+	w->run = 0;
+}
+
+size_t timecode_bin_writer_length (TimecodeBinWriter const * const w) {
+	return w->pos;
+}
+
+int timecode_bin_write (TimecodeBinWriter * const w, Timecode const * const tc) {
+	const int64_t sf = bin_subframes(&w->r);
+	int64_t v, delta;
+
+	if (!bin_same_rate(&w->r, &tc->r)) return -1;
+
+	v = tc_time_to_frames(&tc->t, &w->r) * sf + (w->r.subframes > 0 ? tc->t.subframe : 0);
+	if (w->anchor != INT64_MIN && bin_has_date(&tc->d)) {
+		const int64_t days = tc_days_from_civil(tc->d.year, tc->d.month, tc->d.day) - w->anchor;
+		v += days * tc_frames_per_day(&w->r) * sf;
+	}
+	delta = v - w->expected;
+
+	if (delta == 0) {
+		if (w->run && w->buf[w->run - 1] < TOKEN_RUN_MAX) {
+			w->buf[w->run - 1]++;
+		} else {
+			if (w->pos >= w->size) return -1;
+			w->buf[w->pos++] = 0;
+			w->run = w->pos;
+		}
+	} else {
+		const uint64_t z = zigzag(delta);
+		if (z < 0x40) {
+			if (w->pos >= w->size) return -1;
+			w->buf[w->pos++] = TOKEN_SHORT | z;
+		} else {
+			uint64_t zz = z;
+			size_t len = 2;
+			while (zz >= 0x80) { zz >>= 7; ++len; }
+			if (w->pos + len > w->size) return -1;
+			w->buf[w->pos++] = TOKEN_VARINT;
+			for (zz = z; zz >= 0x80; zz >>= 7) {
+				w->buf[w->pos++] = 0x80 | (zz & 0x7f);
+			}
+			w->buf[w->pos++] = zz;
+		}
+		w->run = 0;
+	}
+	w->expected = v + sf;
+	return 0;
+}
+
+size_t timecode_bin_write_batch (TimecodeBinWriter * const w, Timecode const * const tc, const size_t n) {
+	size_t i;
+	for (i = 0; i < n; ++i) {
+		if (timecode_bin_write(w, &tc[i])) break;
+	}
+	return i;
+}
+
+/*****************************************************************************
+ * reader
+ */
+
+int timecode_bin_reader_init (TimecodeBinReader * const rd, const uint8_t * const buf, const size_t size) {
+	TimecodeRateID id;
+	size_t pos;
+
+	if (size < 11 || memcmp(buf, bin_magic, 4)) return -1;
+	pos = 4;
+	id = (TimecodeRateID) buf[pos++];
+	if (id == TIMECODE_RATE_INVALID) {
+		if (size < 24) return -1;
+		rd->r.num = (int32_t) get_le(&buf[pos], 4); pos += 4;
+		rd->r.den = (int32_t) get_le(&buf[pos], 4); pos += 4;
+		rd->r.drop = buf[pos++] ? 1 : 0;
+		rd->r.subframes = (int32_t) get_le(&buf[pos], 4); pos += 4;
+		if (rd->r.num <= 0 || rd->r.den <= 0 || rd->r.subframes < 0) return -1;
+	} else {
+		TimecodeRate const * const r = timecode_rate_by_id(id);
+		if (!r) return -1;
+		rd->r = *r;
+	}
+	rd->d.year = (int16_t) get_le(&buf[pos], 2); pos += 2;
+	rd->d.month = buf[pos++];
+	rd->d.day = buf[pos++];
+	rd->d.timezone = (int16_t) get_le(&buf[pos], 2); pos += 2;
+
+	rd->buf = buf;
+	rd->size = size;
+	rd->pos = pos;
+	rd->run = 0;
+	rd->expected = 0;
+	if (bin_has_date(&rd->d)) {
+		if (rd->d.month > 12 || rd->d.day < 1 || rd->d.day > 31) return -1;
+		rd->anchor = tc_days_from_civil(rd->d.year, rd->d.month, rd->d.day);
+	} else {
+		rd->anchor = INT64_MIN;
+	}
+	return 0;
+}
+
+void timecode_bin_reader_set_buffer (TimecodeBinReader * const rd, const uint8_t * const buf, const size_t size) {
+	rd->buf = buf;
+	rd->size = size;
+	rd->pos = 0;
+}
+
+int timecode_bin_read (TimecodeBinReader * const rd, Timecode * const tc) {
+	const int64_t sf = bin_subframes(&rd->r);
+	const int64_t day = tc_frames_per_day(&rd->r) * sf;
+	int64_t v, days;
+
+	if (rd->run > 0) {
+		--rd->run;
+		v = rd->expected;
+	} else {
+		uint8_t b;
+		if (rd->pos >= rd->size) return 0;
+		b = rd->buf[rd->pos];
+		if (b <= TOKEN_RUN_MAX) {
+			rd->run = b;
+			v = rd->expected;
+			++rd->pos;
+		} else if (b < TOKEN_VARINT) {
+			v = rd->expected + unzigzag(b & 0x3f);
+			++rd->pos;
+		} else if (b == TOKEN_VARINT) {
+			uint64_t z = 0;
+			size_t p = rd->pos + 1;
+			int shift = 0;
+			for (;;) {
+				if (p >= rd->size || shift > 63) return -1;
+				z |= (uint64_t)(rd->buf[p] & 0x7f) << shift;
+				if (!(rd->buf[p++] & 0x80)) break;
+				shift += 7;
+			}
+			v = rd->expected + unzigzag(z);
+			rd->pos = p;
+		} else {
+			return -1;
+		}
+	}
+	rd->expected = v + sf;
+
+	days = v / day;
+	v %= day;
+	if (v < 0) { v += day; --days; }
+
+	tc_frames_to_time(&tc->t, &rd->r, v / sf);
+	tc->t.subframe = rd->r.subframes > 0 ? v % sf : 0;
+	tc->r = rd->r;
+	tc->d = rd->d;
+	if (rd->anchor != INT64_MIN) {
+		tc_civil_from_days(&tc->d, rd->anchor + days);
+	}
+	return 1;
+}
+
+size_t timecode_bin_read_batch (TimecodeBinReader * const rd, Timecode * const tc, const size_t n) {
+	size_t i;
+	for (i = 0; i < n; ++i) {
+		if (timecode_bin_read(rd, &tc[i]) != 1) break;
+	}
+	return i;
+}
@@ -0,0 +1,118 @@
+/*
+   libtimecode - memoizing sample to timecode converter
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <math.h>
+
+#include "timecode/timecode_cursor.h"
+#include "timecode/timecode_inline.h"
+#include "internal.h"
+
+void timecode_cursor_init (TimecodeCursor * const c, TimecodeRate const * const r, const double samplerate) {
+	memset(c, 0, sizeof(TimecodeCursor));
+	c->r = *r;
+	c->samplerate = samplerate;
+	c->fps_d = (double)r->num / (double)r->den;
+	c->fps_i = ceil(c->fps_d);
+	c->spf = samplerate / c->fps_d;
+	c->fph = (int64_t)rint(3600 * c->fps_i * c->spf);
+}
+
+/* full conversion, and the frame index that corresponds to the result */
+static void cursor_locate (TimecodeCursor * const c, const int64_t sample) {
+	timecode_inline_sample_to_time(&c->t, &c->r, c->samplerate, sample);
+	if (c->r.drop) {
+		c->frame = tc_time_to_frames(&c->t, &c->r);
+	} else {
+		c->base = c->t.hour * c->fph;
+		c->frame = (60 * (int64_t)c->t.minute + c->t.second) * c->fps_i + c->t.frame;
+	}
+	c->lo = c->hi = sample;
+	c->valid = 1;
+}
+
+void timecode_cursor_sample_to_time (TimecodeCursor * const c, TimecodeTime * const t, const int64_t sample) {
+	int64_t frame;
+	int32_t sub;
+
+	if (c->valid && sample >= c->lo && sample <= c->hi) {
+		++c->hits;
+		*t = c->t;
+		return;
+	}
+
+	if (!c->valid || sample < 0) goto miss;
+
+	/* frame and subframe, with the same arithmetic as timecode_inline_sample_to_time() */
+	if (c->r.drop) {
+		frame = floor ((double)sample * c->fps_d / c->samplerate);
+		sub = rint (c->r.subframes * ((double)sample * c->fps_d / c->samplerate - (double)frame));
+	} else {
+		if (sample < c->base || sample >= c->base + c->fph) goto miss;
+		const double exact = (double)(sample - c->base) / c->spf;
+		sub = (int32_t) rint ((exact - floor (exact)) * c->r.subframes);
+		frame = (int64_t) floor (exact);
+	}
+	if (sub == c->r.subframes && c->r.subframes != 0) {
+		sub = 0;
+		++frame;
+	}
+
+	if (frame == c->frame) {
+		if (sub == c->t.subframe) {
+			if (sample < c->lo) c->lo = sample;
+			if (sample > c->hi) c->hi = sample;
+		} else {
+			c->t.subframe = sub;
+			c->lo = c->hi = sample;
+		}
+	} else if (frame == c->frame + 1) {
+		TimecodeTime n = c->t;
+		if (timecode_inline_time_increment(&n, &c->r) || n.hour != c->t.hour) {
+			/* day wrap, or the end of the hour, leave it to the full conversion */
+			goto miss;
+		}
+		n.subframe = sub;
+		c->t = n;
+		c->frame = frame;
+		c->lo = c->hi = sample;
+	} else {
+		goto miss;
+	}
+	++c->near;
+	*t = c->t;
+	return;
+
+miss:
+	++c->misses;
+	cursor_locate(c, sample);
+	*t = c->t;
+}
+
+double timecode_cursor_hit_rate (TimecodeCursor const * const c) {
+	const uint64_t total = c->hits + c->near + c->misses;
+	if (total == 0) return 0;
+	return (double)(c->hits + c->near) / (double)total;
+}
@@ -0,0 +1,388 @@
+/*
+   libtimecode - CMX3600 edit decision lists
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timecode/timecode_edl.h"
+#include "internal.h"
+
+#define EDL_MAX_TOKENS 16
+
+typedef struct {
+	const char *s;
+	size_t len;
+} EdlToken;
+
+/*****************************************************************************
+ * helpers
+ */
+
+static inline int is_digit(const char c) {
+	return c >= '0' && c <= '9';
+}
+
+static inline int is_space(const char c) {
+	return c == ' ' || c == '\t';
+}
+
+static inline int is_sep(const char c) {
+	return c == ':' || c == ';' || c == '.' || c == ',';
+}
+
+static int all_digits(EdlToken const * const t) {
+	size_t i;
+	if (t->len == 0) return 0;
+	for (i = 0; i < t->len; ++i) {
+		if (!is_digit(t->s[i])) return 0;
+	}
+	return 1;
+}
+
+static void copy_token(char * const dst, const size_t size, EdlToken const * const t) {
+	const size_t len = t->len < size - 1 ? t->len : size - 1;
+	memcpy(dst, t->s, len);
+	dst[len] = '\0';
+}
+
+static inline int digit2(const char *p) {
+	return (p[0] - '0') * 10 + (p[1] - '0');
+}
+
+/* same as timecode_parse_time(): a dropped label maps to the next frame */
+static inline void drop_fixup(TimecodeTime * const t, TimecodeRate const * const r) {
+	if (r->drop && (t->minute % 10 != 0) && (t->second == 0) && (t->frame == 0)) {
+		t->frame = 2;
+	}
+}
+
+/* parse a timecode token to a frame number, return -1 on error */
+static int parse_frames(int64_t * const frames, EdlToken const * const tok, TimecodeRate const * const r) {
+	const char *p = tok->s;
+	TimecodeTime t;
+	int64_t days = 0;
+	int32_t v[4];
+	int n, digits;
+	size_t i;
+
+	if (   tok->len == 11
+	    && is_digit(p[0]) && is_digit(p[1]) && is_sep(p[2])
+	    && is_digit(p[3]) && is_digit(p[4]) && is_sep(p[5])
+	    && is_digit(p[6]) && is_digit(p[7]) && is_sep(p[8])
+	    && is_digit(p[9]) && is_digit(p[10])) {
+		/* fixed-width fast path */
+		t.hour     = digit2(p);
+		t.minute   = digit2(p + 3);
+		t.second   = digit2(p + 6);
+		t.frame    = digit2(p + 9);
+		t.subframe = 0;
+		if (t.minute >= 60 || t.second >= 60 || t.frame >= TC_FPS_I(r)) {
+			goto slow;
+		}
+	} else {
+slow:
+		/* 2 to 4 fields, right-aligned: [[HH:]MM:]SS:FF */
+		v[0] = v[1] = v[2] = v[3] = 0;
+		n = digits = 0;
+		for (i = 0; i < tok->len; ++i) {
+			if (is_digit(p[i])) {
+				if (++digits > 9) return -1;
+				v[n] = v[n] * 10 + (p[i] - '0');
+			} else if (is_sep(p[i]) && n < 3) {
+				++n;
+				digits = 0;
+			} else {
+				return -1;
+			}
+		}
+		if (n == 0) return -1;
+		t.frame    = v[n];
+		t.second   = v[n - 1];
+		t.minute   = n > 1 ? v[n - 2] : 0;
+		t.hour     = n > 2 ? v[n - 3] : 0;
+		t.subframe = 0;
+		days = tc_move_time_overflow(&t, r);
+	}
+	drop_fixup(&t, r);
+	*frames = tc_time_to_frames(&t, r) + days * tc_frames_per_day(r);
+	return 0;
+}
+
+static int edl_grow(TimecodeEdl * const edl) {
+	const size_t a = edl->alloc ? 2 * edl->alloc : 256;
+	void *p;
+#define GROW(field) \
+	if (!(p = realloc(edl->field, a * sizeof(*edl->field)))) return -1; \
+	edl->field = p;
+	GROW(event)
+	GROW(reel)
+	GROW(track)
+	GROW(transition)
+	GROW(duration)
+	GROW(drop)
+	GROW(src_in)
+	GROW(src_out)
+	GROW(rec_in)
+	GROW(rec_out)
+#undef GROW
+	edl->alloc = a;
+	return 0;
+}
+
+/*****************************************************************************
+ * parser
+ */
+
+static void parse_event(TimecodeEdl * const edl, EdlToken const * const tok, const int n, TimecodeRate const * const r) {
+	const size_t i = edl->count;
+	int k;
+
+	/* event reel track transition [duration] src-in src-out rec-in rec-out */
+	if (n < 8 || !all_digits(&tok[0])) {
+		++edl->skipped;
+		return;
+	}
+	if (   parse_frames(&edl->src_in[i],  &tok[n - 4], r)
+	    || parse_frames(&edl->src_out[i], &tok[n - 3], r)
+	    || parse_frames(&edl->rec_in[i],  &tok[n - 2], r)
+	    || parse_frames(&edl->rec_out[i], &tok[n - 1], r)) {
+		++edl->skipped;
+		return;
+	}
+	edl->event[i] = atoi(tok[0].s);
+	copy_token(edl->reel[i], TIMECODE_EDL_REEL_MAX, &tok[1]);
+	copy_token(edl->track[i], TIMECODE_EDL_TRACK_MAX, &tok[2]);
+	edl->transition[i] = tok[3].s[0];
+	edl->duration[i] = 0;
+	for (k = 4; k < n - 4; ++k) {
+		if (all_digits(&tok[k])) {
+			edl->duration[i] = atoi(tok[k].s);
+			break;
+		}
+	}
+	edl->drop[i] = r->drop ? 1 : 0;
+	if (i == 0) {
+		edl->rate.drop = r->drop;
+	}
+	++edl->count;
+}
+
+TimecodeEdl *timecode_edl_parse (const char *text, const size_t len, TimecodeRate const * const rate) {
+	const char * const end = text + len;
+	const char *p = text;
+	TimecodeRate r = *rate;
+	TimecodeEdl *edl = (TimecodeEdl*) calloc(1, sizeof(TimecodeEdl));
+
+	if (!edl) return NULL;
+	edl->rate = r;
+
+	while (p < end) {
+		const char *eol = memchr(p, '\n', end - p);
+		const char *q;
+		EdlToken tok[EDL_MAX_TOKENS];
+		int n = 0;
+
+		if (!eol) eol = end;
+		while (p < eol && is_space(*p)) ++p;
+
+		if (p < eol && is_digit(*p)) {
+			if (edl->count == edl->alloc && edl_grow(edl)) {
+				timecode_edl_free(edl);
+				return NULL;
+			}
+			const char *e = eol;
+			int tail = 0;
+			while (e > p && (is_space(e[-1]) || e[-1] == '\r')) --e;
+			/* fast path: four space-separated 11 character timecodes at the end */
+			if (e - p > 48 && is_space(e[-12]) && is_space(e[-24]) && is_space(e[-36]) && is_space(e[-48])) {
+				tail = 4;
+				e -= 48;
+			}
+			for (q = p; q < e && n < EDL_MAX_TOKENS - tail; ) {
+				while (q < e && (is_space(*q) || *q == '\r')) ++q;
+				if (q == e) break;
+				tok[n].s = q;
+				while (q < e && !is_space(*q) && *q != '\r') ++q;
+				tok[n].len = q - tok[n].s;
+				++n;
+			}
+			for (q = e + 1; tail > 0; --tail, q += 12) {
+				tok[n].s = q;
+				tok[n].len = 11;
+				++n;
+			}
+			parse_event(edl, tok, n, &r);
+		} else if (eol - p > 4 && !strncmp(p, "FCM:", 4)) {
+			for (q = p + 4; q + 3 <= eol; ++q) {
+				if (!strncmp(q, "NON", 3)) break;
+			}
+			/* only 29.97 and 30 fps drop-frame are supported */
+			r.drop = (q + 3 > eol && TC_FPS_I(&r) == 30) ? 1 : 0;
+		} else if (eol - p > 6 && !strncmp(p, "TITLE:", 6)) {
+			EdlToken t;
+			t.s = p + 6;
+			while (t.s < eol && is_space(*t.s)) ++t.s;
+			t.len = eol - t.s;
+			while (t.len > 0 && (is_space(t.s[t.len - 1]) || t.s[t.len - 1] == '\r')) --t.len;
+			copy_token(edl->title, sizeof(edl->title), &t);
+		}
+		p = eol + 1;
+	}
+	return edl;
+}
+
+TimecodeEdl *timecode_edl_load (const char *path, TimecodeRate const * const r) {
+	TimecodeEdl *edl;
+	tc_mapped_file m;
+	if (tc_map_file(&m, path)) return NULL;
+	edl = timecode_edl_parse((const char*) m.data, m.size, r);
+	tc_unmap_file(&m);
+	return edl;
+}
+
+void timecode_edl_free (TimecodeEdl *edl) {
+	if (!edl) return;
+	free(edl->event);
+	free(edl->reel);
+	free(edl->track);
+	free(edl->transition);
+	free(edl->duration);
+	free(edl->drop);
+	free(edl->src_in);
+	free(edl->src_out);
+	free(edl->rec_in);
+	free(edl->rec_out);
+	free(edl);
+}
+
+/*****************************************************************************
+ * writer
+ */
+
+typedef struct {
+	char *buf;
+	size_t size;
+	size_t pos;
+} EdlOut;
+
+static void out_mem(EdlOut * const o, const char *s, const size_t len) {
+	if (o->pos < o->size) {
+		const size_t n = o->pos + len < o->size ? len : o->size - o->pos;
+		memcpy(o->buf + o->pos, s, n);
+	}
+	o->pos += len;
+}
+
+static void out_str(EdlOut * const o, const char *s) {
+	out_mem(o, s, strlen(s));
+}
+
+static void out_padded(EdlOut * const o, const char *s, const size_t width) {
+	static const char spaces[] = "                                ";
+	const size_t len = strlen(s);
+	out_mem(o, s, len);
+	if (len < width) out_mem(o, spaces, width - len);
+}
+
+/* zero-padded decimal */
+static void out_int(EdlOut * const o, int32_t v, const int width) {
+	char s[12];
+	int n = 0;
+	if (v < 0) v = 0;
+	do {
+		s[sizeof(s) - 1 - n++] = '0' + v % 10;
+		v /= 10;
+	} while (v > 0 || n < width);
+	out_mem(o, &s[sizeof(s) - n], n);
+}
+
+static void out_tc(EdlOut * const o, const int64_t frames, TimecodeRate const * const r, const char term) {
+	TimecodeTime t;
+	char s[12];
+	tc_frames_to_time(&t, r, frames);
+	s[0]  = '0' + (t.hour / 10) % 10; s[1]  = '0' + t.hour % 10;   s[2] = ':';
+	s[3]  = '0' + t.minute / 10;      s[4]  = '0' + t.minute % 10; s[5] = ':';
+	s[6]  = '0' + t.second / 10;      s[7]  = '0' + t.second % 10; s[8] = r->drop ? ';' : ':';
+	s[9]  = '0' + (t.frame / 10) % 10; s[10] = '0' + t.frame % 10;
+	s[11] = term;
+	out_mem(o, s, 12);
+}
+
+size_t timecode_edl_format (TimecodeEdl const * const edl, char *buf, const size_t size) {
+	EdlOut o = { buf, size, 0 };
+	TimecodeRate r = edl->rate;
+	size_t i;
+	int drop = -1;
+
+	if (edl->title[0]) {
+		out_str(&o, "TITLE: ");
+		out_str(&o, edl->title);
+		out_str(&o, "\n");
+	}
+	for (i = 0; i < edl->count; ++i) {
+		if (edl->drop[i] != drop) {
+			drop = edl->drop[i];
+			r.drop = drop;
+			out_str(&o, drop ? "FCM: DROP FRAME\n" : "FCM: NON-DROP FRAME\n");
+		}
+		out_int(&o, edl->event[i], 3);
+		out_mem(&o, "  ", 2);
+		out_padded(&o, edl->reel[i], 8);
+		out_mem(&o, " ", 1);
+		out_padded(&o, edl->track[i], 6);
+		out_mem(&o, edl->transition[i] ? &edl->transition[i] : "C", 1);
+		if (edl->duration[i] > 0) {
+			out_mem(&o, "    ", 4);
+			out_int(&o, edl->duration[i], 3);
+			out_mem(&o, "  ", 2);
+		} else {
+			out_mem(&o, "         ", 9);
+		}
+		out_tc(&o, edl->src_in[i], &r, ' ');
+		out_tc(&o, edl->src_out[i], &r, ' ');
+		out_tc(&o, edl->rec_in[i], &r, ' ');
+		out_tc(&o, edl->rec_out[i], &r, '\n');
+	}
+	if (size > 0) {
+		buf[o.pos < size ? o.pos : size - 1] = '\0';
+	}
+	return o.pos;
+}
+
+int timecode_edl_save (TimecodeEdl const * const edl, const char *path) {
+	const size_t len = timecode_edl_format(edl, NULL, 0);
+	char *buf = malloc(len + 1);
+	FILE *f;
+	int rv = -1;
+	if (!buf) return -1;
+	timecode_edl_format(edl, buf, len + 1);
+	if ((f = fopen(path, "wb"))) {
+		if (fwrite(buf, 1, len, f) == len) rv = 0;
+		if (fclose(f)) rv = -1;
+	}
+	free(buf);
+	return rv;
+}
@@ -0,0 +1,361 @@
+/*
+   libtimecode - memory-mapped frame index
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "timecode/timecode_index.h"
+#include "internal.h"
+
+/* "TCIX" read as little-endian uint32, a mismatch also detects foreign byte order */
+#define INDEX_MAGIC   0x58494354
+#define INDEX_VERSION 3
+
+typedef struct {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t page_size;
+	uint32_t record_size;
+	uint64_t count;
+	uint64_t runs_offset;
+	uint64_t order_offset;
+	uint64_t file_size;
+	uint64_t wrap_days;   ///< number of midnights crossed by the longest run without date
+} IndexHeader;
+
+/* runs in timecode order */
+typedef struct {
+	TimecodeTicks end;     ///< key of the last frame of the run
+	TimecodeTicks max_end; ///< largest end of this and all previous entries
+	uint32_t run;          ///< index into the runs array
+	uint32_t reserved;
+} IndexOrder;
+
+struct TimecodeIndex {
+	tc_mapped_file file;
+	size_t count;
+	uint64_t wrap_days;
+	TimecodeIndexRun const *runs;
+	IndexOrder const *order;
+};
+
+/*****************************************************************************
+ * helpers
+ */
+
+static inline int64_t page_align(const int64_t x) {
+	return (x + TIMECODE_INDEX_PAGE_SIZE - 1) & ~(int64_t)(TIMECODE_INDEX_PAGE_SIZE - 1);
+}
+
+static inline int index_has_date(TimecodeDate const * const d) {
+	return d->month > 0;
+}
+
+static inline int64_t index_days(TimecodeDate const * const d) {
+	return index_has_date(d) ? tc_days_from_civil(d->year, d->month, d->day) : 0;
+}
+
+static inline int index_same_rate(TimecodeRate const * const a, TimecodeRate const * const b) {
+	return a->num == b->num && a->den == b->den
+		&& (a->drop != 0) == (b->drop != 0) && a->subframes == b->subframes;
+}
+
+/* frames since midnight of 1970-01-01, counting timecode labels: a day has
+ * tc_frames_per_day() frames, regardless of its duration at fractional rates */
+static int64_t index_label_frames(Timecode const * const tc) {
+	return index_days(&tc->d) * tc_frames_per_day(&tc->r) + tc_time_to_frames(&tc->t, &tc->r);
+}
+
+/* sort key, increases with every frame of a run */
+static TimecodeTicks index_key(TimecodeRate const * const r, const int64_t label_frames) {
+	return timecode_framenumber_to_ticks(label_frames, r);
+}
+
+static int cmp_frame(const void *a, const void *b) {
+	const TimecodeIndexRun *ra = (const TimecodeIndexRun*) a;
+	const TimecodeIndexRun *rb = (const TimecodeIndexRun*) b;
+	if (ra->frame != rb->frame) return ra->frame < rb->frame ? -1 : 1;
+	return 0;
+}
+
+/* run start in timecode order, sorted by value to keep qsort reentrant */
+typedef struct {
+	TimecodeTicks key;
+	int64_t frame;
+	uint32_t idx;
+} KeyEntry;
+
+static int cmp_key(const void *a, const void *b) {
+	KeyEntry const * const ea = (KeyEntry const*) a;
+	KeyEntry const * const eb = (KeyEntry const*) b;
+	if (ea->key != eb->key) return ea->key < eb->key ? -1 : 1;
+	if (ea->frame != eb->frame) return ea->frame < eb->frame ? -1 : 1;
+	return 0;
+}
+
+/*****************************************************************************
+ * write
+ */
+
+static int write_all(const int fd, const void *buf, size_t len) {
+	const char *p = (const char*) buf;
+	while (len > 0) {
+		const ssize_t rv = write(fd, p, len);
+		if (rv <= 0) return -1;
+		p += rv;
+		len -= rv;
+	}
+	return 0;
+}
+
+static int write_pad(const int fd, int64_t len) {
+	static const char zero[256];
+	while (len > 0) {
+		const size_t n = len > (int64_t)sizeof(zero) ? sizeof(zero) : (size_t)len;
+		if (write_all(fd, zero, n)) return -1;
+		len -= n;
+	}
+	return 0;
+}
+
+int timecode_index_write (const char *path, TimecodeIndexRun const * const runs, const size_t n) {
+	TimecodeIndexRun *r;
+	KeyEntry *keys;
+	IndexOrder *order;
+	IndexHeader h;
+	size_t i;
+	int fd, rv = -1;
+
+	if (n > UINT32_MAX) return -1;
+	r = malloc((n ? n : 1) * sizeof(TimecodeIndexRun));
+	keys = malloc((n ? n : 1) * sizeof(KeyEntry));
+	order = malloc((n ? n : 1) * sizeof(IndexOrder));
+	if (!r || !keys || !order) goto out;
+
+	memset(&h, 0, sizeof(h));
+	memcpy(r, runs, n * sizeof(TimecodeIndexRun));
+	qsort(r, n, sizeof(TimecodeIndexRun), cmp_frame);
+	for (i = 0; i < n; ++i) {
+		if (r[i].length <= 0 || r[i].tc.r.num <= 0 || r[i].tc.r.den <= 0) goto out;
+		if (i > 0 && r[i - 1].frame + r[i - 1].length > r[i].frame) goto out;
+		r[i].tc.t.subframe = 0;
+		r[i].key = index_key(&r[i].tc.r, index_label_frames(&r[i].tc));
+		r[i].reserved = 0;
+		keys[i].key = r[i].key;
+		keys[i].frame = r[i].frame;
+		keys[i].idx = i;
+	}
+	qsort(keys, n, sizeof(KeyEntry), cmp_key);
+	for (i = 0; i < n; ++i) {
+		TimecodeIndexRun const * const ri = &r[keys[i].idx];
+		const int64_t last = index_label_frames(&ri->tc) + ri->length - 1;
+		order[i].end = index_key(&ri->tc.r, last);
+		order[i].max_end = (i > 0 && order[i - 1].max_end > order[i].end) ? order[i - 1].max_end : order[i].end;
+		order[i].run = keys[i].idx;
+		order[i].reserved = 0;
+		if (!index_has_date(&ri->tc.d) && (uint64_t)(last / tc_frames_per_day(&ri->tc.r)) > h.wrap_days) {
+			h.wrap_days = last / tc_frames_per_day(&ri->tc.r);
+		}
+	}
+
+	h.magic = INDEX_MAGIC;
+	h.version = INDEX_VERSION;
+	h.page_size = TIMECODE_INDEX_PAGE_SIZE;
+	h.record_size = sizeof(TimecodeIndexRun);
+	h.count = n;
+	h.runs_offset = TIMECODE_INDEX_PAGE_SIZE;
+	h.order_offset = page_align(h.runs_offset + n * sizeof(TimecodeIndexRun));
+	h.file_size = page_align(h.order_offset + n * sizeof(IndexOrder));
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) goto out;
+	if (   !write_all(fd, &h, sizeof(h))
+	    && !write_pad(fd, h.runs_offset - sizeof(h))
+	    && !write_all(fd, r, n * sizeof(TimecodeIndexRun))
+	    && !write_pad(fd, h.order_offset - h.runs_offset - n * sizeof(TimecodeIndexRun))
+	    && !write_all(fd, order, n * sizeof(IndexOrder))
+	    && !write_pad(fd, h.file_size - h.order_offset - n * sizeof(IndexOrder))) {
+		rv = 0;
+	}
+	if (close(fd)) rv = -1;
+
+out:
+	free(order);
+	free(keys);
+	free(r);
+	return rv;
+}
+
+/*****************************************************************************
+ * open/close
+ */
+
+/* the section [offset, offset + n * size) is page-aligned, after the header
+ * and inside the file */
+static int index_section_valid(IndexHeader const * const h, const uint64_t offset, const uint64_t size) {
+	return offset >= TIMECODE_INDEX_PAGE_SIZE && offset % TIMECODE_INDEX_PAGE_SIZE == 0
+		&& offset <= h->file_size && h->count <= (h->file_size - offset) / size;
+}
+
+/* everything the lookup relies on, same checks as timecode_index_write() */
+static int index_valid(IndexHeader const * const h, TimecodeIndexRun const * const runs, IndexOrder const * const order) {
+	uint64_t i, wrap_days = 0;
+	for (i = 0; i < h->count; ++i) {
+		TimecodeIndexRun const * const r = &runs[i];
+		if (order[i].run >= h->count) return 0;
+		if (r->length <= 0 || r->tc.r.num <= 0 || r->tc.r.den <= 0) return 0;
+		if (i > 0 && runs[i - 1].frame + runs[i - 1].length > r->frame) return 0;
+		if (!index_has_date(&r->tc.d)) {
+			const int64_t last = index_label_frames(&r->tc) + r->length - 1;
+			if ((uint64_t)(last / tc_frames_per_day(&r->tc.r)) > wrap_days) {
+				wrap_days = last / tc_frames_per_day(&r->tc.r);
+			}
+		}
+	}
+	return wrap_days == h->wrap_days;
+}
+
+TimecodeIndex *timecode_index_open (const char *path) {
+	TimecodeIndex *idx;
+	IndexHeader const *h;
+
+	idx = calloc(1, sizeof(TimecodeIndex));
+	if (!idx) return NULL;
+	if (tc_map_file(&idx->file, path) || idx->file.size < TIMECODE_INDEX_PAGE_SIZE) {
+		timecode_index_close(idx);
+		return NULL;
+	}
+
+	h = (IndexHeader const*) idx->file.data;
+	if (   h->magic != INDEX_MAGIC || h->version != INDEX_VERSION
+	    || h->page_size != TIMECODE_INDEX_PAGE_SIZE || h->record_size != sizeof(TimecodeIndexRun)
+	    || h->file_size > idx->file.size || h->count > UINT32_MAX
+	    || !index_section_valid(h, h->runs_offset, sizeof(TimecodeIndexRun))
+	    || !index_section_valid(h, h->order_offset, sizeof(IndexOrder))
+	    || h->order_offset < h->runs_offset
+	    || h->order_offset - h->runs_offset < h->count * sizeof(TimecodeIndexRun)) {
+		timecode_index_close(idx);
+		return NULL;
+	}
+	idx->count = h->count;
+	idx->runs = (TimecodeIndexRun const*) ((const char*)idx->file.data + h->runs_offset);
+	idx->order = (IndexOrder const*) ((const char*)idx->file.data + h->order_offset);
+	idx->wrap_days = h->wrap_days;
+	if (!index_valid(h, idx->runs, idx->order)) {
+		timecode_index_close(idx);
+		return NULL;
+	}
+	return idx;
+}
+
+void timecode_index_close (TimecodeIndex *idx) {
+	if (!idx) return;
+	tc_unmap_file(&idx->file);
+	free(idx);
+}
+
+size_t timecode_index_count (TimecodeIndex const * const idx) {
+	return idx->count;
+}
+
+TimecodeIndexRun const *timecode_index_runs (TimecodeIndex const * const idx) {
+	return idx->runs;
+}
+
+/*****************************************************************************
+ * lookup
+ */
+
+int timecode_index_frame_to_timecode (TimecodeIndex const * const idx, const int64_t frame, Timecode * const tc) {
+	TimecodeIndexRun const *r;
+	size_t lo = 0, hi = idx->count;
+	int64_t f, fpd, days;
+
+	/* last run that starts at or before the frame */
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (idx->runs[mid].frame <= frame) lo = mid + 1; else hi = mid;
+	}
+	if (lo == 0) return -1;
+	r = &idx->runs[lo - 1];
+	if (frame >= r->frame + r->length) return -1;
+
+	fpd = tc_frames_per_day(&r->tc.r);
+	f = tc_time_to_frames(&r->tc.t, &r->tc.r) + frame - r->frame;
+	days = f / fpd;
+
+	tc->r = r->tc.r;
+	tc->d = r->tc.d;
+	tc_frames_to_time(&tc->t, &r->tc.r, f % fpd);
+	tc->t.subframe = 0;
+	if (days > 0 && index_has_date(&r->tc.d)) {
+		tc_civil_from_days(&tc->d, index_days(&r->tc.d) + days);
+	}
+	return 0;
+}
+
+/* latest run that starts at or before the key, and contains the label */
+static int index_find(TimecodeIndex const * const idx, TimecodeRate const * const rate, const int has_date, const int64_t label_frames, int64_t * const frame) {
+	const TimecodeTicks key = index_key(rate, label_frames);
+	size_t lo = 0, hi = idx->count;
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (idx->runs[idx->order[mid].run].key <= key) lo = mid + 1; else hi = mid;
+	}
+	/* earlier runs may be long enough to contain the key */
+	for (; lo > 0 && idx->order[lo - 1].max_end >= key; --lo) {
+		IndexOrder const * const o = &idx->order[lo - 1];
+		TimecodeIndexRun const * const r = &idx->runs[o->run];
+		if (o->end < key) continue;
+		if (!index_same_rate(&r->tc.r, rate) || index_has_date(&r->tc.d) != has_date) continue;
+		const int64_t f = label_frames - index_label_frames(&r->tc);
+		if (f < 0 || f >= r->length) continue;
+		*frame = r->frame + f;
+		return 1;
+	}
+	return 0;
+}
+
+int timecode_index_timecode_to_frame (TimecodeIndex const * const idx, Timecode const * const tc, int64_t * const frame) {
+	const int64_t fpd = tc_frames_per_day(&tc->r);
+	const int64_t label = tc_time_to_frames(&tc->t, &tc->r);
+	uint64_t day;
+
+	if (index_has_date(&tc->d) && index_find(idx, &tc->r, 1, index_label_frames(tc), frame)) {
+		return 0;
+	}
+	/* runs without date, which may wrap around midnight */
+	for (day = 0; day <= idx->wrap_days; ++day) {
+		if (index_find(idx, &tc->r, 0, label + (int64_t)day * fpd, frame)) {
+			return 0;
+		}
+	}
+	return -1;
+}
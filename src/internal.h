@@ -0,0 +1,218 @@
+/*
+   libtimecode - internal helpers, not installed
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_INTERNAL_H
+#define TIMECODE_INTERNAL_H 1
+
+#include <stdint.h>
+#include <stddef.h>
+#include "timecode/timecode.h"
+
+/* built-in rates, timecode.c */
+extern const TimecodeRate tcfps23976;
+extern const TimecodeRate tcfps24;
+extern const TimecodeRate tcfps24976;
+extern const TimecodeRate tcfps25;
+extern const TimecodeRate tcfps2997ndf;
+extern const TimecodeRate tcfps2997df;
+extern const TimecodeRate tcfps30;
+extern const TimecodeRate tcfps30df;
+extern const TimecodeRate tcfps5994;
+extern const TimecodeRate tcfps60;
+extern const TimecodeRate tcfpsDS;
+extern const TimecodeRate tcfpsCS;
+extern const TimecodeRate tcfpsMS;
+extern const TimecodeRate tcfpsUS;
+extern const TimecodeRate tcfpsNS;
+
+/* integer frames per second, same as ceil(num/den) */
+#define TC_FPS_I(r) (((r)->num + (r)->den - 1) / (r)->den)
+
+/*****************************************************************************
+ * exact integer timecode <> frame-number
+ *
+ * these produce the same results as timecode_to_framenumber() and
+ * timecode_framenumber_to_time(), without floating-point.
+ */
+
+static inline int64_t tc_time_to_frames(TimecodeTime const * const t, TimecodeRate const * const r) {
+	const int64_t fps_i = TC_FPS_I(r);
+	int64_t frames = fps_i * (3600 * (int64_t)t->hour + 60 * t->minute + t->second) + t->frame;
+	if (r->drop) {
+		const int64_t totalMinutes = 60 * (int64_t)t->hour + t->minute;
+		frames -= 2 * (totalMinutes - totalMinutes / 10);
+	}
+	return frames;
+}
+
+static inline void tc_frames_to_time(TimecodeTime * const t, TimecodeRate const * const r, int64_t frames) {
+	const int64_t fps_i = TC_FPS_I(r);
+	if (r->drop) {
+		/* frames per 10 minutes, and per dropped minute */
+		const int64_t f10 = 600 * fps_i - 18;
+		const int64_t f1  =  60 * fps_i - 2;
+		const int64_t D = frames / f10;
+		const int64_t M = frames % f10;
+		frames += 18 * D + 2 * ((M - 2) / f1);
+	}
+	t->frame  =    frames % fps_i;
+	t->second =   (frames / fps_i) % 60;
+	t->minute =  ((frames / fps_i) / 60) % 60;
+	t->hour   = (((frames / fps_i) / 60) / 60);
+}
+
+/* number of frames in 24 hours */
+static inline int64_t tc_frames_per_day(TimecodeRate const * const r) {
+	const int64_t fps_i = TC_FPS_I(r);
+	if (r->drop) {
+		return 24 * 6 * (600 * fps_i - 18);
+	}
+	return 24 * 3600 * fps_i;
+}
+
+/*****************************************************************************
+ * proleptic Gregorian calendar <> days since 1970-01-01
+ */
+
+static inline int64_t tc_days_from_civil(int64_t y, const int32_t m, const int32_t d) {
+	y -= m <= 2;
+	const int64_t era = (y >= 0 ? y : y - 399) / 400;
+	const int64_t yoe = y - era * 400;
+	const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+static inline void tc_civil_from_days(TimecodeDate * const date, int64_t z) {
+	z += 719468;
+	const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+	const int64_t doe = z - era * 146097;
+	const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	const int64_t mp = (5 * doy + 2) / 153;
+	date->day = doy - (153 * mp + 2) / 5 + 1;
+	date->month = mp < 10 ? mp + 3 : mp - 9;
+	date->year = yoe + era * 400 + (date->month <= 2);
+}
+
+/*****************************************************************************
+ * exact rational scaling: x * num / den
+ */
+
+static inline int64_t tc_gcd(int64_t a, int64_t b) {
+	if (a < 0) a = -a;
+	if (b < 0) b = -b;
+	while (b) {
+		const int64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/* round to nearest, half away from zero. num >= 0, den > 0 */
+static inline int64_t tc_muldiv_round(const int64_t x, const int64_t num, const int64_t den) {
+#ifdef __SIZEOF_INT128__
+	const __int128 p = (__int128)x * num;
+	const __int128 q = p / den;
+	const __int128 r = p % den;
+	if (2 * (r < 0 ? -r : r) >= den) {
+		return (int64_t)(p < 0 ? q - 1 : q + 1);
+	}
+	return (int64_t)q;
+#else
+	/* exact as long as num * den < 2^63 */
+	const int64_t q = x / den;
+	const int64_t rn = (x % den) * num;
+	int64_t res = q * num + rn / den;
+	const int64_t r = rn % den;
+	if (2 * (r < 0 ? -r : r) >= den) {
+		res += (rn < 0) ? -1 : 1;
+	}
+	return res;
+#endif
+}
+
+/* round towards negative infinity. num >= 0, den > 0 */
+static inline int64_t tc_muldiv_floor(const int64_t x, const int64_t num, const int64_t den) {
+#ifdef __SIZEOF_INT128__
+	const __int128 p = (__int128)x * num;
+	__int128 q = p / den;
+	if ((p % den) < 0) --q;
+	return (int64_t)q;
+#else
+	const int64_t q = x / den;
+	const int64_t rn = (x % den) * num;
+	int64_t res = q * num + rn / den;
+	if ((rn % den) < 0) --res;
+	return res;
+#endif
+}
+
+/* -1, 0 or +1 to apply to a truncated quotient with remainder r */
+static inline int64_t tc_round_adjust(const int64_t r, const int64_t den, const int rnd) {
+	switch (rnd) {
+		case TIMECODE_ROUND_DOWN:
+			return r < 0 ? -1 : 0;
+		case TIMECODE_ROUND_UP:
+			return r > 0 ? 1 : 0;
+		case TIMECODE_ROUND_ZERO:
+			return 0;
+		default:
+			if (r < 0) return -r >= den + r ? -1 : 0;
+			return r >= den - r ? 1 : 0;
+	}
+}
+
+/* x * num / den with a TimecodeRounding mode. num >= 0, den > 0 */
+static inline int64_t tc_muldiv_rnd(const int64_t x, const int64_t num, const int64_t den, const int rnd) {
+	int64_t p;
+	if (!__builtin_mul_overflow(x, num, &p)) {
+		return p / den + tc_round_adjust(p % den, den, rnd);
+	}
+#ifdef __SIZEOF_INT128__
+	const __int128 pw = (__int128)x * num;
+	return (int64_t)(pw / den) + tc_round_adjust((int64_t)(pw % den), den, rnd);
+#else
+	/* exact as long as num * den < 2^63 */
+	const int64_t rn = (x % den) * num;
+	return (x / den) * num + rn / den + tc_round_adjust(rn % den, den, rnd);
+#endif
+}
+
+/*****************************************************************************
+ * read-only file mapping, mapfile.c
+ */
+
+typedef struct {
+	void *data;
+	size_t size;
+	int mapped; ///< 1: mmap(), 0: malloc()
+} tc_mapped_file;
+
+/* normalize out-of-range time fields, return the 24 hour overflow in days */
+int32_t tc_move_time_overflow(TimecodeTime * const t, TimecodeRate const * const r);
+
+/* map a complete file, falls back to reading it if mmap() is not available */
+int tc_map_file(tc_mapped_file * const m, const char *path);
+void tc_unmap_file(tc_mapped_file * const m);
+
+#endif
@@ -0,0 +1,140 @@
+/*
+   libtimecode - per frame-rate specialized conversion kernels
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "timecode/timecode_kernels.h"
+#include "stats.h"
+
+#define TIMECODE_INLINE_SLOWPATH(id) TC_STAT(TIMECODE_STAT_##id)
+#include "timecode/timecode_inline.h"
+
+/*****************************************************************************
+ * format, shared by all rates
+ */
+
+static void k_time_to_string (char *smptestring, TimecodeTime const * const t) {
+	if (   (uint32_t)t->hour > 99 || (uint32_t)t->minute > 99
+	    || (uint32_t)t->second > 99 || (uint32_t)t->frame > 99) {
+		timecode_time_to_string(smptestring, t);
+		return;
+	}
+	smptestring[0]  = '0' + t->hour / 10;
+	smptestring[1]  = '0' + t->hour % 10;
+	smptestring[2]  = ':';
+	smptestring[3]  = '0' + t->minute / 10;
+	smptestring[4]  = '0' + t->minute % 10;
+	smptestring[5]  = ':';
+	smptestring[6]  = '0' + t->second / 10;
+	smptestring[7]  = '0' + t->second % 10;
+	smptestring[8]  = ':';
+	smptestring[9]  = '0' + t->frame / 10;
+	smptestring[10] = '0' + t->frame % 10;
+	smptestring[11] = '\0';
+}
+
+/*****************************************************************************
+ * specialized kernels
+ *
+ * the inline functions are instantiated with a constant rate,
+ * the compiler resolves r->drop and ceil(num/den) at compile-time.
+ */
+
+#define TC_KERNELS(ID, NAME, NUM, DEN, DROP, SUB) \
+static const TimecodeRate k_rate_##ID = { NUM, DEN, DROP, SUB }; \
+\
+static int64_t k_to_sample_##ID (TimecodeTime const * const t, TimecodeRate const * const r, const double samplerate) { \
+	(void) r; \
+	return timecode_inline_to_sample(t, &k_rate_##ID, samplerate); \
+} \
+static void k_sample_to_time_##ID (TimecodeTime * const t, TimecodeRate const * const r, const double samplerate, const int64_t sample) { \
+	(void) r; \
+	timecode_inline_sample_to_time(t, &k_rate_##ID, samplerate, sample); \
+} \
+static int64_t k_to_framenumber_##ID (TimecodeTime const * const t, TimecodeRate const * const r) { \
+	(void) r; \
+	return timecode_inline_to_framenumber(t, &k_rate_##ID); \
+} \
+static void k_framenumber_to_time_##ID (TimecodeTime * const t, TimecodeRate const * const r, const int64_t frameno) { \
+	(void) r; \
+	timecode_inline_framenumber_to_time(t, &k_rate_##ID, frameno); \
+} \
+static int k_time_increment_##ID (TimecodeTime * const t, TimecodeRate const * const r) { \
+	(void) r; \
+	return timecode_inline_time_increment(t, &k_rate_##ID); \
+} \
+static int k_time_decrement_##ID (TimecodeTime * const t, TimecodeRate const * const r) { \
+	(void) r; \
+	return timecode_inline_time_decrement(t, &k_rate_##ID); \
+} \
+\
+static const TimecodeKernels k_##ID = { \
+	&k_rate_##ID, NAME, \
+	k_to_sample_##ID, k_sample_to_time_##ID, \
+	k_to_framenumber_##ID, k_framenumber_to_time_##ID, \
+	k_time_increment_##ID, k_time_decrement_##ID, \
+	k_time_to_string, \
+};
+
+TC_KERNELS(23976,   "23.976",      24000, 1001, 0, 80)
+TC_KERNELS(24,      "24",             24,    1, 0, 80)
+TC_KERNELS(24976,   "24.976",      25000, 1001, 0, 80)
+TC_KERNELS(25,      "25",             25,    1, 0, 80)
+TC_KERNELS(2997ndf, "29.97",       30000, 1001, 0, 80)
+TC_KERNELS(2997df,  "29.97df",     30000, 1001, 1, 80)
+TC_KERNELS(30,      "30",             30,    1, 0, 80)
+TC_KERNELS(30df,    "30df",           30,    1, 1, 80)
+TC_KERNELS(5994,    "59.94",       60000, 1001, 0, 80)
+TC_KERNELS(60,      "60",             60,    1, 0, 80)
+TC_KERNELS(DS,      "10",             10,    1, 0, 1000)
+TC_KERNELS(CS,      "100",           100,    1, 0, 1000)
+TC_KERNELS(MS,      "1000",         1000,    1, 0, 1000)
+TC_KERNELS(US,      "1000000",   1000000,    1, 0, 1)
+TC_KERNELS(NS,      "1000000000", 1000000000, 1, 0, 1)
+
+static const TimecodeKernels k_generic = {
+	NULL, "generic",
+	timecode_to_sample, timecode_sample_to_time,
+	timecode_to_framenumber, timecode_framenumber_to_time,
+	timecode_time_increment, timecode_time_decrement,
+	timecode_time_to_string,
+};
+
+/* most common first */
+static TimecodeKernels const * const kernels[] = {
+	&k_25, &k_2997df, &k_24, &k_23976, &k_30, &k_2997ndf,
+	&k_5994, &k_60, &k_24976, &k_30df,
+	&k_MS, &k_DS, &k_CS, &k_US, &k_NS,
+};
+
+TimecodeKernels const *timecode_rate_kernels (TimecodeRate const * const r) {
+	size_t i;
+	for (i = 0; i < sizeof(kernels) / sizeof(TimecodeKernels const *); ++i) {
+		TimecodeRate const * const k = kernels[i]->rate;
+		if (   k->num == r->num && k->den == r->den
+		    && (k->drop != 0) == (r->drop != 0) && k->subframes == r->subframes) {
+			return kernels[i];
+		}
+	}
+	return &k_generic;
+}
@@ -0,0 +1,226 @@
+/*
+   libtimecode - LTC audio encoder
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "timecode/timecode_ltc.h"
+
+#define LTC_BITS 80
+#define LTC_HALFBITS (2 * LTC_BITS)
+
+struct TimecodeLTCEncoder {
+	TimecodeRate r;
+	int32_t samplerate;
+	TimecodeTime t;       ///< timecode of the current frame
+	uint32_t userbits;
+	float amplitude;
+
+	int64_t frame;        ///< frames since last reset
+	int64_t pos;          ///< absolute sample position of the next output sample
+	int64_t base;         ///< sample position of the last reset
+
+	int64_t step_q;       ///< half-bit period: step_q + step_r / step_d samples
+	int64_t step_r;
+	int64_t step_d;
+
+	int hb;               ///< current half-bit 0..159
+	signed char level;    ///< output level at the end of the previous frame
+	int64_t edge[LTC_HALFBITS + 1]; ///< absolute sample position of every half-bit edge
+	signed char out[LTC_HALFBITS];  ///< biphase-mark level of every half-bit
+};
+
+/*****************************************************************************
+ * LTC frame
+ */
+
+static void ltc_setbits(unsigned char *bits, int offset, int nbits, int value) {
+	int i;
+	for (i = 0; i < nbits; ++i) {
+		if (value & (1 << i)) {
+			bits[(offset + i) >> 3] |= 1 << ((offset + i) & 7);
+		}
+	}
+}
+
+static int ltc_getbit(unsigned char const *bits, int i) {
+	return (bits[i >> 3] >> (i & 7)) & 1;
+}
+
+/* SMPTE 12M - bit 0 is sent first */
+static void ltc_pack_frame(TimecodeLTCEncoder const *e, unsigned char *bits) {
+	int i, ones = 0;
+	const int fps_i = ceil((double)e->r.num / (double)e->r.den);
+
+	memset(bits, 0, LTC_BITS / 8);
+	ltc_setbits(bits,  0, 4, e->t.frame % 10);
+	ltc_setbits(bits,  8, 2, e->t.frame / 10);
+	ltc_setbits(bits, 10, 1, e->r.drop ? 1 : 0);
+	ltc_setbits(bits, 16, 4, e->t.second % 10);
+	ltc_setbits(bits, 24, 3, e->t.second / 10);
+	ltc_setbits(bits, 32, 4, e->t.minute % 10);
+	ltc_setbits(bits, 40, 3, e->t.minute / 10);
+	ltc_setbits(bits, 48, 4, e->t.hour % 10);
+	ltc_setbits(bits, 56, 2, e->t.hour / 10);
+
+	for (i = 0; i < 8; ++i) {
+		ltc_setbits(bits, 4 + 8 * i, 4, (e->userbits >> (4 * i)) & 0xf);
+	}
+
+	/* sync word 0011 1111 1111 1101 */
+	ltc_setbits(bits, 64, 16, 0xbffc);
+
+	/* biphase polarity correction: even number of ones per frame,
+	 * so that every frame starts with the same transition */
+	for (i = 0; i < LTC_BITS; ++i) {
+		ones += ltc_getbit(bits, i);
+	}
+	if (ones & 1) {
+		ltc_setbits(bits, fps_i == 25 ? 59 : 27, 1, 1);
+	}
+}
+
+/* compute biphase levels and the bit-edge schedule of the current frame */
+static void ltc_prepare_frame(TimecodeLTCEncoder *e) {
+	unsigned char bits[LTC_BITS / 8];
+	signed char level = e->level;
+	int64_t pos, rem;
+	int i;
+
+	ltc_pack_frame(e, bits);
+
+	for (i = 0; i < LTC_BITS; ++i) {
+		level = -level;
+		e->out[2 * i] = level;
+		if (ltc_getbit(bits, i)) {
+			level = -level;
+		}
+		e->out[2 * i + 1] = level;
+	}
+	e->level = level;
+
+	/* edge of half-bit H = floor (H * samplerate * den / (num * 160)),
+	 * computed from the absolute half-bit count to avoid drift */
+	const int64_t hbit = e->frame * LTC_HALFBITS;
+	const int64_t sd = (int64_t) e->samplerate * e->r.den;
+	pos = (hbit / e->step_d) * sd + ((hbit % e->step_d) * sd) / e->step_d;
+	rem = ((hbit % e->step_d) * sd) % e->step_d;
+
+	for (i = 0; i <= LTC_HALFBITS; ++i) {
+		e->edge[i] = e->base + pos;
+		pos += e->step_q;
+		rem += e->step_r;
+		if (rem >= e->step_d) {
+			rem -= e->step_d;
+			++pos;
+		}
+	}
+	e->hb = 0;
+}
+
+static void ltc_next_frame(TimecodeLTCEncoder *e) {
+	timecode_time_increment(&e->t, &e->r);
+	++e->frame;
+	ltc_prepare_frame(e);
+}
+
+/*****************************************************************************
+ * public API
+ */
+
+TimecodeLTCEncoder *timecode_ltc_encoder_create (TimecodeRate const * const r, const int32_t samplerate, TimecodeTime const * const start) {
+	TimecodeLTCEncoder *e;
+	if (r->num < 1 || r->den < 1 || samplerate < 1) return NULL;
+	if (ceil((double)r->num / (double)r->den) > 30) return NULL;
+
+	e = (TimecodeLTCEncoder*) calloc(1, sizeof(TimecodeLTCEncoder));
+	if (!e) return NULL;
+
+	memcpy(&e->r, r, sizeof(TimecodeRate));
+	e->samplerate = samplerate;
+	e->amplitude = .5;
+	e->step_d = (int64_t) r->num * LTC_HALFBITS;
+	e->step_q = ((int64_t) samplerate * r->den) / e->step_d;
+	e->step_r = ((int64_t) samplerate * r->den) % e->step_d;
+	e->level = 1;
+	timecode_ltc_encoder_reset(e, start);
+	return e;
+}
+
+void timecode_ltc_encoder_free (TimecodeLTCEncoder *e) {
+	free(e);
+}
+
+void timecode_ltc_encoder_reset (TimecodeLTCEncoder *e, TimecodeTime const * const t) {
+	memcpy(&e->t, t, sizeof(TimecodeTime));
+	e->t.subframe = 0;
+	e->base = e->pos;
+	e->frame = 0;
+	ltc_prepare_frame(e);
+}
+
+void timecode_ltc_encoder_set_volume (TimecodeLTCEncoder *e, const float amplitude) {
+	e->amplitude = amplitude;
+}
+
+void timecode_ltc_encoder_set_userbits (TimecodeLTCEncoder *e, const uint32_t userbits) {
+	e->userbits = userbits;
+}
+
+void timecode_ltc_encoder_get_time (TimecodeLTCEncoder const *e, TimecodeTime * const t) {
+	memcpy(t, &e->t, sizeof(TimecodeTime));
+}
+
+/* process runs of constant level, the schedule is shared by all channels */
+#define LTC_RENDER(TYPE, VALUE)                                        \
+	size_t i = 0;                                                        \
+	while (i < nsamples) {                                               \
+		const int64_t end = e->edge[e->hb + 1];                            \
+		size_t run = nsamples - i;                                         \
+		if ((int64_t) run > end - e->pos) run = end - e->pos;              \
+		if (run > 0) {                                                     \
+			const TYPE v = VALUE;                                            \
+			unsigned int c;                                                  \
+			for (c = 0; c < nchannels; ++c) {                                \
+				TYPE *b = bufs[c] + i;                                         \
+				size_t j;                                                      \
+				for (j = 0; j < run; ++j) b[j] = v;                            \
+			}                                                                \
+			i += run;                                                        \
+			e->pos += run;                                                   \
+		}                                                                  \
+		if (e->pos >= end) {                                               \
+			if (++e->hb == LTC_HALFBITS) ltc_next_frame(e);                  \
+		}                                                                  \
+	}
+
+void timecode_ltc_encoder_render_float (TimecodeLTCEncoder *e, float * const * bufs, const unsigned int nchannels, const size_t nsamples) {
+	LTC_RENDER(float, e->out[e->hb] * e->amplitude)
+}
+
+void timecode_ltc_encoder_render_int16 (TimecodeLTCEncoder *e, int16_t * const * bufs, const unsigned int nchannels, const size_t nsamples) {
+	LTC_RENDER(int16_t, (int16_t) lrintf(e->out[e->hb] * e->amplitude * 32767.f))
+}
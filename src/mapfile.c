@@ -0,0 +1,95 @@
+/*
+   libtimecode - read-only file mapping
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "internal.h"
+
+int tc_map_file(tc_mapped_file * const m, const char *path) {
+	struct stat st;
+	const int fd = open(path, O_RDONLY);
+
+	m->data = NULL;
+	m->size = 0;
+	m->mapped = 0;
+	if (fd < 0) return -1;
+	if (fstat(fd, &st) || st.st_size <= 0) {
+		close(fd);
+		return -1;
+	}
+	m->size = st.st_size;
+
+#ifdef HAVE_SYS_MMAN_H
+	m->data = mmap(NULL, m->size, PROT_READ, MAP_SHARED, fd, 0);
+	if (m->data != MAP_FAILED) {
+		m->mapped = 1;
+		close(fd);
+		return 0;
+	}
+	m->data = NULL;
+#endif
+
+	{
+		/* fall back to reading the complete file */
+		size_t off = 0;
+		m->data = malloc(m->size);
+		while (m->data && off < m->size) {
+			const ssize_t rv = read(fd, (char*)m->data + off, m->size - off);
+			if (rv <= 0) {
+				free(m->data);
+				m->data = NULL;
+				break;
+			}
+			off += rv;
+		}
+	}
+	close(fd);
+	if (!m->data) {
+		m->size = 0;
+		return -1;
+	}
+	return 0;
+}
+
+void tc_unmap_file(tc_mapped_file * const m) {
+#ifdef HAVE_SYS_MMAN_H
+	if (m->mapped) {
+		munmap(m->data, m->size);
+	} else
+#endif
+	{
+		free(m->data);
+	}
+	m->data = NULL;
+	m->size = 0;
+	m->mapped = 0;
+}
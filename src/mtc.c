@@ -0,0 +1,253 @@
+/*
+   libtimecode - MIDI Time Code
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+#include <math.h>
+
+#include "timecode/timecode_mtc.h"
+
+/*****************************************************************************
+ * Encoder
+ */
+
+/* sample position of quarter-frame qf: floor (qf * samplerate * den / (4 * num)) */
+static int64_t mtc_qf_sample(TimecodeMTCEncoder const * const e, const int64_t qf) {
+	const int64_t sd = (int64_t) e->samplerate * e->r.den;
+	const int64_t q  = 4 * (int64_t) e->r.num;
+	return (qf / q) * sd + ((qf % q) * sd) / q;
+}
+
+static uint8_t mtc_qf_data(TimecodeMTCEncoder const * const e, const int piece) {
+	switch (piece) {
+		case 0: return e->seq.frame & 0xf;
+		case 1: return (e->seq.frame >> 4) & 0x1;
+		case 2: return e->seq.second & 0xf;
+		case 3: return (e->seq.second >> 4) & 0x3;
+		case 4: return e->seq.minute & 0xf;
+		case 5: return (e->seq.minute >> 4) & 0x3;
+		case 6: return e->seq.hour & 0xf;
+		default: return ((e->seq.hour >> 4) & 0x1) | (e->type << 1);
+	}
+}
+
+int timecode_mtc_encoder_init (TimecodeMTCEncoder * const e, TimecodeRate const * const r, const int32_t samplerate, TimecodeTime const * const start) {
+	if (r->num < 1 || r->den < 1 || samplerate < 1) return -1;
+
+	switch ((int) ceil((double)r->num / (double)r->den)) {
+		case 24:
+			e->type = 0;
+			break;
+		case 25:
+			e->type = 1;
+			break;
+		case 30:
+			e->type = r->drop ? 2 : 3;
+			break;
+		default:
+			return -1;
+	}
+
+	memcpy(&e->r, r, sizeof(TimecodeRate));
+	e->samplerate = samplerate;
+	timecode_mtc_encoder_locate(e, start);
+	return 0;
+}
+
+void timecode_mtc_encoder_locate (TimecodeMTCEncoder * const e, TimecodeTime const * const t) {
+	memcpy(&e->t, t, sizeof(TimecodeTime));
+	e->t.subframe = 0;
+	memcpy(&e->seq, &e->t, sizeof(TimecodeTime));
+	e->qf = 0;
+	e->next = 0;
+	e->pos = 0;
+	e->full = 1;
+}
+
+size_t timecode_mtc_encoder_process (TimecodeMTCEncoder * const e, const uint32_t nsamples, TimecodeMTCMessage * const msg, const size_t max) {
+	const int64_t end = e->pos + nsamples;
+	size_t n = 0;
+
+	if (e->full && n < max) {
+		msg[n].offset  = 0;
+		msg[n].size    = 10;
+		msg[n].data[0] = 0xf0;
+		msg[n].data[1] = 0x7f;
+		msg[n].data[2] = 0x7f; // all devices
+		msg[n].data[3] = 0x01; // MTC
+		msg[n].data[4] = 0x01; // full message
+		msg[n].data[5] = (e->type << 5) | (e->t.hour & 0x1f);
+		msg[n].data[6] = e->t.minute;
+		msg[n].data[7] = e->t.second;
+		msg[n].data[8] = e->t.frame;
+		msg[n].data[9] = 0xf7;
+		++n;
+	}
+	e->full = 0;
+
+	while (e->next < end) {
+		const int piece = e->qf & 7;
+		if (n < max) {
+			msg[n].offset  = e->next - e->pos;
+			msg[n].size    = 2;
+			msg[n].data[0] = 0xf1;
+			msg[n].data[1] = (piece << 4) | mtc_qf_data(e, piece);
+			++n;
+		}
+
+		if ((e->qf & 3) == 3) {
+			timecode_time_increment(&e->t, &e->r);
+		}
+		++e->qf;
+		e->next = mtc_qf_sample(e, e->qf);
+		if ((e->qf & 7) == 0) {
+			memcpy(&e->seq, &e->t, sizeof(TimecodeTime));
+		}
+	}
+
+	e->pos = end;
+	return n;
+}
+
+/*****************************************************************************
+ * Decoder
+ */
+
+static void mtc_set_rate(Timecode * const tc, const int type) {
+	switch (type) {
+		case 0:
+			timecode_copy_rate(tc, timecode_FPS24);
+			break;
+		case 1:
+			timecode_copy_rate(tc, timecode_FPS25);
+			break;
+		case 2:
+			timecode_copy_rate(tc, timecode_FPS2997DF);
+			break;
+		default:
+			timecode_copy_rate(tc, timecode_FPS30);
+			break;
+	}
+}
+
+static int mtc_decode_full(TimecodeMTCDecoder * const d) {
+	/* F0 7F <device> 01 01 hh mm ss ff F7 */
+	if (d->sysex_len != 8 || d->sysex[0] != 0x7f || d->sysex[2] != 0x01 || d->sysex[3] != 0x01) {
+		return 0;
+	}
+	mtc_set_rate(&d->tc, (d->sysex[4] >> 5) & 3);
+	timecode_set_time(&d->tc, d->sysex[4] & 0x1f, d->sysex[5], d->sysex[6], d->sysex[7], 0);
+	d->direction = 0;
+	d->pieces = 0;
+	d->last = -1;
+	return 1;
+}
+
+static int mtc_decode_qf(TimecodeMTCDecoder * const d, const uint8_t data) {
+	const int piece = (data >> 4) & 7;
+	int dir = 0;
+
+	if (d->last >= 0) {
+		if (piece == ((d->last + 1) & 7)) {
+			dir = 1;
+		} else if (piece == ((d->last + 7) & 7)) {
+			dir = -1;
+		}
+	}
+
+	if (dir == 0) {
+		d->pieces = 0;
+	} else if (d->direction != 0 && dir != d->direction) {
+		d->pieces = 1; // the previous piece is part of the new sequence
+	}
+
+	d->direction = dir;
+	d->last = piece;
+	d->piece[piece] = data & 0xf;
+	++d->pieces;
+
+	if (d->pieces < 8) return 0;
+	if (!((dir > 0 && piece == 7) || (dir < 0 && piece == 0))) return 0;
+
+	mtc_set_rate(&d->tc, (d->piece[7] >> 1) & 3);
+	timecode_set_time(&d->tc,
+			d->piece[6] | ((d->piece[7] & 1) << 4),
+			d->piece[4] | ((d->piece[5] & 3) << 4),
+			d->piece[2] | ((d->piece[3] & 3) << 4),
+			d->piece[0] | ((d->piece[1] & 1) << 4),
+			0);
+
+	/* the sequence took two frames to transmit */
+	if (dir > 0) {
+		timecode_time_increment(&d->tc.t, &d->tc.r);
+		timecode_time_increment(&d->tc.t, &d->tc.r);
+	} else {
+		timecode_time_decrement(&d->tc.t, &d->tc.r);
+		timecode_time_decrement(&d->tc.t, &d->tc.r);
+	}
+	return 1;
+}
+
+void timecode_mtc_decoder_init (TimecodeMTCDecoder * const d) {
+	memset(d, 0, sizeof(TimecodeMTCDecoder));
+	d->sysex_len = -1;
+	d->last = -1;
+}
+
+int timecode_mtc_decoder_parse (TimecodeMTCDecoder * const d, const uint8_t *buf, const size_t len, Timecode * const tc) {
+	int rv = 0;
+	size_t i;
+
+	for (i = 0; i < len; ++i) {
+		const uint8_t b = buf[i];
+		if (b >= 0xf8) {
+			continue; // realtime messages may appear anywhere
+		}
+		if (b & 0x80) {
+			if (b == 0xf7 && d->sysex_len >= 0) {
+				rv |= mtc_decode_full(d);
+			}
+			d->sysex_len = (b == 0xf0) ? 0 : -1;
+			d->qf_status = (b == 0xf1);
+			continue;
+		}
+		if (d->qf_status) {
+			d->qf_status = 0;
+			rv |= mtc_decode_qf(d, b);
+		} else if (d->sysex_len >= 0) {
+			if (d->sysex_len < 10) {
+				d->sysex[d->sysex_len++] = b;
+			}
+		}
+	}
+
+	if (rv && tc) {
+		memcpy(tc, &d->tc, sizeof(Timecode));
+	}
+	return rv;
+}
+
+int timecode_mtc_decoder_direction (TimecodeMTCDecoder const * const d) {
+	return d->direction;
+}
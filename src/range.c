@@ -0,0 +1,219 @@
+/*
+   libtimecode - generate consecutive timecodes
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "timecode/timecode_range.h"
+#include "internal.h"
+
+#define MIN_FRAMES_PER_THREAD 65536
+#define MAX_THREADS 64
+
+static const char digit_pairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/* advance to frame 0 of the next second, or frame 2 at a dropped minute */
+static inline void next_second (TimecodeTime * const t, TimecodeRate const * const r) {
+	t->frame = 0;
+	if (++t->second < 60) return;
+	t->second = 0;
+	if (++t->minute == 60) {
+		t->minute = 0;
+		++t->hour;
+	}
+	if (r->drop && (t->minute % 10) != 0) {
+		t->frame = 2;
+	}
+}
+
+/***** serial kernels */
+
+static void fill_serial (TimecodeTime * const out, TimecodeRate const * const r, const int64_t first, const size_t n) {
+	const int32_t fps_i = TC_FPS_I(r);
+	TimecodeTime t;
+	size_t i = 0;
+
+	tc_frames_to_time(&t, r, first);
+	while (i < n) {
+		const int32_t f0 = t.frame;
+		size_t len = fps_i - f0;
+		size_t j;
+		if (len > n - i) len = n - i;
+		TimecodeTime * const o = out + i;
+		for (j = 0; j < len; ++j) {
+			o[j].hour     = t.hour;
+			o[j].minute   = t.minute;
+			o[j].second   = t.second;
+			o[j].frame    = f0 + (int32_t)j;
+			o[j].subframe = 0;
+		}
+		i += len;
+		next_second(&t, r);
+	}
+}
+
+static void format_serial (char * const out, TimecodeRate const * const r, const int64_t first, const size_t n, const char separator) {
+	const int32_t fps_i = TC_FPS_I(r);
+	char tpl[TIMECODE_RANGE_STRIDE];
+	TimecodeTime t;
+	size_t i = 0;
+
+	tc_frames_to_time(&t, r, first);
+	tpl[2] = tpl[5] = tpl[8] = ':';
+	tpl[11] = separator;
+	while (i < n) {
+		const int32_t f0 = t.frame;
+		size_t len = fps_i - f0;
+		size_t j;
+		if (len > n - i) len = n - i;
+		memcpy(tpl,     digit_pairs + 2 * t.hour,   2);
+		memcpy(tpl + 3, digit_pairs + 2 * t.minute, 2);
+		memcpy(tpl + 6, digit_pairs + 2 * t.second, 2);
+		char *o = out + i * TIMECODE_RANGE_STRIDE;
+		for (j = 0; j < len; ++j, o += TIMECODE_RANGE_STRIDE) {
+			memcpy(o, tpl, TIMECODE_RANGE_STRIDE);
+			memcpy(o + 9, digit_pairs + 2 * (f0 + j), 2);
+		}
+		i += len;
+		next_second(&t, r);
+	}
+}
+
+/***** threads */
+
+typedef struct {
+	char *out;
+	size_t stride;
+	TimecodeRate const *r;
+	int64_t first;
+	size_t n;
+	int format;
+	char separator;
+#ifdef HAVE_PTHREAD
+	pthread_t thread;
+	int started;
+#endif
+} range_job;
+
+static void *range_run (void *arg) {
+	range_job const * const j = (range_job const*) arg;
+	if (j->format) {
+		format_serial(j->out, j->r, j->first, j->n, j->separator);
+	} else {
+		fill_serial((TimecodeTime*) j->out, j->r, j->first, j->n);
+	}
+	return NULL;
+}
+
+static void range_dispatch (range_job const * const job, int n_threads) {
+#ifdef HAVE_PTHREAD
+	range_job jobs[MAX_THREADS];
+	size_t per, done = 0;
+	int i;
+
+	if (n_threads > MAX_THREADS) n_threads = MAX_THREADS;
+	if ((size_t)n_threads > job->n / MIN_FRAMES_PER_THREAD) {
+		n_threads = job->n / MIN_FRAMES_PER_THREAD;
+	}
+	if (n_threads <= 1) {
+		range_run((void*) job);
+		return;
+	}
+
+	per = (job->n + n_threads - 1) / n_threads;
+	for (i = 0; i < n_threads; ++i) {
+		jobs[i] = *job;
+		jobs[i].out   = job->out + done * job->stride;
+		jobs[i].first = job->first + (int64_t)done;
+		jobs[i].n     = (job->n - done) < per ? (job->n - done) : per;
+		jobs[i].started = 0;
+		done += jobs[i].n;
+	}
+
+	/* the calling thread takes the first part, and any part that failed to start */
+	for (i = 1; i < n_threads; ++i) {
+		jobs[i].started = !pthread_create(&jobs[i].thread, NULL, range_run, &jobs[i]);
+	}
+	range_run(&jobs[0]);
+	for (i = 1; i < n_threads; ++i) {
+		if (jobs[i].started) {
+			pthread_join(jobs[i].thread, NULL);
+		} else {
+			range_run(&jobs[i]);
+		}
+	}
+#else
+	(void) n_threads;
+	range_run((void*) job);
+#endif
+}
+
+/***** API */
+
+int timecode_range_fill (TimecodeTime * const out, TimecodeRate const * const r, const int64_t first, const size_t n, const int n_threads) {
+	range_job job;
+	if (first < 0) return -1;
+	if (n == 0) return 0;
+	memset(&job, 0, sizeof(job));
+	job.out = (char*) out;
+	job.stride = sizeof(TimecodeTime);
+	job.r = r;
+	job.first = first;
+	job.n = n;
+	range_dispatch(&job, n_threads);
+	return 0;
+}
+
+int timecode_range_format (char * const out, TimecodeRate const * const r, const int64_t first, const size_t n, const char separator, const int n_threads) {
+	range_job job;
+	TimecodeTime last;
+	if (first < 0 || TC_FPS_I(r) > 100) return -1;
+	if (n == 0) return 0;
+	tc_frames_to_time(&last, r, first + (int64_t)n - 1);
+	if (last.hour >= 100) return -1;
+	memset(&job, 0, sizeof(job));
+	job.out = out;
+	job.stride = TIMECODE_RANGE_STRIDE;
+	job.r = r;
+	job.first = first;
+	job.n = n;
+	job.format = 1;
+	job.separator = separator;
+	range_dispatch(&job, n_threads);
+	return 0;
+}
@@ -0,0 +1,188 @@
+/*
+   libtimecode - frame-rate registry
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "timecode/timecode_rates.h"
+#include "internal.h"
+
+/* indexed by TimecodeRateID */
+static TimecodeRate const * const rate_ids[TIMECODE_RATE_COUNT] = {
+	NULL,
+	&tcfps23976,
+	&tcfps24,
+	&tcfps24976,
+	&tcfps25,
+	&tcfps2997ndf,
+	&tcfps2997df,
+	&tcfps30,
+	&tcfps30df,
+	&tcfps5994,
+	&tcfps60,
+	&tcfpsDS,
+	&tcfpsCS,
+	&tcfpsMS,
+	&tcfpsUS,
+	&tcfpsNS,
+};
+
+static const char * const rate_names[TIMECODE_RATE_COUNT] = {
+	NULL,
+	"23.976", "24", "24.976", "25", "29.97", "29.97df", "30", "30df", "59.94", "60",
+	"ds", "cs", "ms", "us", "ns",
+};
+
+/*****************************************************************************
+ * perfect hash
+ *
+ * FNV-1a of the lower-case name, starting with RATE_HASH_SEED; the top 7 bits
+ * index rate_slots[]. The seed was chosen by brute-force search such that
+ * all aliases map to distinct slots. When adding an alias, search a new
+ * seed and regenerate rate_slots[] (entries are 1 + index into rate_aliases[]).
+ */
+
+typedef struct {
+	const char *name;
+	TimecodeRateID id;
+} RateAlias;
+
+static const RateAlias rate_aliases[] = {
+	{ "23.976", 1 },
+	{ "23.98", 1 },
+	{ "24000/1001", 1 },
+	{ "2398", 1 },
+	{ "23976", 1 },
+	{ "24", 2 },
+	{ "24/1", 2 },
+	{ "24.976", 3 },
+	{ "24.98", 3 },
+	{ "25000/1001", 3 },
+	{ "2498", 3 },
+	{ "24976", 3 },
+	{ "25", 4 },
+	{ "25/1", 4 },
+	{ "pal", 4 },
+	{ "29.97", 5 },
+	{ "29.97ndf", 5 },
+	{ "30000/1001", 5 },
+	{ "2997", 5 },
+	{ "2997ndf", 5 },
+	{ "29.97df", 6 },
+	{ "2997df", 6 },
+	{ "30000/1001df", 6 },
+	{ "ntsc", 6 },
+	{ "30", 7 },
+	{ "30/1", 7 },
+	{ "30ndf", 7 },
+	{ "30df", 8 },
+	{ "59.94", 9 },
+	{ "59.94ndf", 9 },
+	{ "60000/1001", 9 },
+	{ "5994", 9 },
+	{ "60", 10 },
+	{ "60/1", 10 },
+	{ "10", 11 },
+	{ "ds", 11 },
+	{ "100", 12 },
+	{ "cs", 12 },
+	{ "1000", 13 },
+	{ "ms", 13 },
+	{ "1000000", 14 },
+	{ "us", 14 },
+	{ "1000000000", 15 },
+	{ "ns", 15 },
+};
+
+#define RATE_HASH_SEED 258392u
+
+static const uint8_t rate_slots[128] = {
+	 0, 26,  0,  0, 33,  0,  0,  0,  0,  0,  0, 20,  0, 10, 31,  0,
+	 2,  0, 37,  0,  0,  0,  0,  1,  0,  0,  0, 44, 38,  0, 21, 42,
+	36, 16,  0, 29, 34,  7,  0, 40, 28,  0,  0,  0, 23,  0,  0, 22,
+	 0,  0, 24,  0,  0,  0,  0,  0,  0, 30,  0, 25,  0,  0,  8, 17,
+	 0,  0, 19,  0,  0, 35,  6, 13,  0, 41,  0,  0,  4,  0,  0,  9,
+	 0,  0, 43,  0,  0,  0,  0, 18,  0,  0,  0, 32,  0,  0,  0,  0,
+	 0, 12,  0, 14,  0,  3,  0,  0,  0,  0,  0, 11,  0,  0, 15,  0,
+	39,  0,  0,  0,  5,  0,  0,  0,  0,  0,  0,  0, 27,  0,  0,  0,
+};
+
+static inline char lower(const char c) {
+	return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+TimecodeRateID timecode_rate_lookup_n (const char *name, const size_t len) {
+	uint32_t h = RATE_HASH_SEED;
+	size_t i;
+	RateAlias const *a;
+	if (len == 0 || len > 12) return TIMECODE_RATE_INVALID;
+
+	for (i = 0; i < len; ++i) {
+		h ^= (uint8_t) lower(name[i]);
+		h *= 16777619u;
+	}
+	if (!rate_slots[h >> 25]) return TIMECODE_RATE_INVALID;
+	a = &rate_aliases[rate_slots[h >> 25] - 1];
+
+	for (i = 0; i < len; ++i) {
+		if (a->name[i] != lower(name[i])) return TIMECODE_RATE_INVALID;
+	}
+	if (a->name[len] != '\0') return TIMECODE_RATE_INVALID;
+	return a->id;
+}
+
+TimecodeRateID timecode_rate_lookup (const char *name) {
+	return timecode_rate_lookup_n(name, strlen(name));
+}
+
+size_t timecode_rate_lookup_bulk (TimecodeRateID * const ids, const char * const * const names, const size_t n) {
+	size_t i, found = 0;
+	for (i = 0; i < n; ++i) {
+		ids[i] = timecode_rate_lookup(names[i]);
+		if (ids[i] != TIMECODE_RATE_INVALID) ++found;
+	}
+	return found;
+}
+
+TimecodeRate const *timecode_rate_by_id (const TimecodeRateID id) {
+	if (id <= TIMECODE_RATE_INVALID || id >= TIMECODE_RATE_COUNT) return NULL;
+	return rate_ids[id];
+}
+
+TimecodeRateID timecode_rate_id (TimecodeRate const * const r) {
+	int i;
+	for (i = 1; i < TIMECODE_RATE_COUNT; ++i) {
+		TimecodeRate const * const k = rate_ids[i];
+		if (   k->num == r->num && k->den == r->den
+		    && (k->drop != 0) == (r->drop != 0) && k->subframes == r->subframes) {
+			return (TimecodeRateID) i;
+		}
+	}
+	return TIMECODE_RATE_INVALID;
+}
+
+const char *timecode_rate_name (const TimecodeRateID id) {
+	if (id <= TIMECODE_RATE_INVALID || id >= TIMECODE_RATE_COUNT) return NULL;
+	return rate_names[id];
+}
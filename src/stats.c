@@ -0,0 +1,155 @@
+/*
+   libtimecode - hot-path instrumentation counters
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "timecode/timecode_stats.h"
+#include "stats.h"
+
+static const char * const stat_names[TIMECODE_STAT_COUNT] = {
+	"timecode_to_sample",
+	"timecode_sample_to_time",
+	"timecode_convert_rate",
+	"timecode_time_add",
+	"timecode_time_subtract",
+	"timecode_time_compare",
+	"timecode_time_increment",
+	"timecode_time_decrement",
+	"timecode_parse_time",
+	"dropframe",
+	"subframe_carry",
+	"overflow",
+	"day_wrap",
+};
+
+const char *timecode_stats_name (const int c) {
+	if (c < 0 || c >= TIMECODE_STAT_COUNT) return NULL;
+	return stat_names[c];
+}
+
+#ifdef TIMECODE_INSTRUMENTATION
+
+#include <pthread.h>
+
+__thread tc_stats_block *tc_stats_tls = NULL;
+
+/* all live thread blocks, and the sum of exited threads */
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static tc_stats_block *stats_threads = NULL;
+static tc_stats_block stats_retired;
+static pthread_key_t stats_key;
+static pthread_once_t stats_once = PTHREAD_ONCE_INIT;
+
+static void stats_thread_exit (void *arg) {
+	tc_stats_block *b = (tc_stats_block*) arg;
+	tc_stats_block **p;
+	int i;
+	pthread_mutex_lock(&stats_lock);
+	for (p = &stats_threads; *p; p = &(*p)->next) {
+		if (*p == b) {
+			*p = b->next;
+			break;
+		}
+	}
+	for (i = 0; i < TIMECODE_STAT_COUNT; ++i) {
+		stats_retired.count[i] += b->count[i];
+		stats_retired.cycles[i] += b->cycles[i];
+	}
+	pthread_mutex_unlock(&stats_lock);
+	free(b);
+}
+
+static void stats_init (void) {
+	pthread_key_create(&stats_key, stats_thread_exit);
+}
+
+tc_stats_block *tc_stats_register (void) {
+	static __thread tc_stats_block unregistered;
+	tc_stats_block *b = calloc(1, sizeof(tc_stats_block));
+	if (!b) {
+		/* out of memory: count into a private block that is never reported */
+		tc_stats_tls = &unregistered;
+		return &unregistered;
+	}
+	pthread_once(&stats_once, stats_init);
+	pthread_setspecific(stats_key, b);
+	pthread_mutex_lock(&stats_lock);
+	b->next = stats_threads;
+	stats_threads = b;
+	pthread_mutex_unlock(&stats_lock);
+	tc_stats_tls = b;
+	return b;
+}
+
+int timecode_stats_snapshot (TimecodeStats * const s) {
+	tc_stats_block const *b;
+	int i;
+	memset(s, 0, sizeof(TimecodeStats));
+	pthread_mutex_lock(&stats_lock);
+	for (i = 0; i < TIMECODE_STAT_COUNT; ++i) {
+		s->count[i] = stats_retired.count[i];
+		s->cycles[i] = stats_retired.cycles[i];
+	}
+	for (b = stats_threads; b; b = b->next) {
+		for (i = 0; i < TIMECODE_STAT_COUNT; ++i) {
+			s->count[i] += __atomic_load_n(&b->count[i], __ATOMIC_RELAXED);
+			s->cycles[i] += __atomic_load_n(&b->cycles[i], __ATOMIC_RELAXED);
+		}
+	}
+	pthread_mutex_unlock(&stats_lock);
+#ifdef TC_STATS_TIMING
+	s->timing = 1;
+#endif
+	return 0;
+}
+
+void timecode_stats_reset (void) {
+	tc_stats_block *b;
+	int i;
+	pthread_mutex_lock(&stats_lock);
+	memset(stats_retired.count, 0, sizeof(stats_retired.count));
+	memset(stats_retired.cycles, 0, sizeof(stats_retired.cycles));
+	for (b = stats_threads; b; b = b->next) {
+		for (i = 0; i < TIMECODE_STAT_COUNT; ++i) {
+			__atomic_store_n(&b->count[i], 0, __ATOMIC_RELAXED);
+			__atomic_store_n(&b->cycles[i], 0, __ATOMIC_RELAXED);
+		}
+	}
+	pthread_mutex_unlock(&stats_lock);
+}
+
+#else
+
+int timecode_stats_snapshot (TimecodeStats * const s) {
+	memset(s, 0, sizeof(TimecodeStats));
+	return -1;
+}
+
+void timecode_stats_reset (void) {
+	;
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+   libtimecode - instrumentation hooks, not installed
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_STATS_INTERNAL_H
+#define TIMECODE_STATS_INTERNAL_H 1
+
+#include "timecode/timecode_stats.h"
+
+/* TC_STAT(id)          count a call or slow-path hit
+ * TC_TIMER_BEGIN       start timing, once at the top of a function
+ * TC_TIMER_END(id)     add elapsed cycles, before the (single) return
+ *
+ * all expand to nothing unless configured with --enable-instrumentation
+ */
+
+#ifdef TIMECODE_INSTRUMENTATION
+
+typedef struct tc_stats_block {
+	uint64_t count[TIMECODE_STAT_COUNT];
+	uint64_t cycles[TIMECODE_STAT_COUNT];
+	struct tc_stats_block *next;
+} tc_stats_block;
+
+extern __thread tc_stats_block *tc_stats_tls;
+tc_stats_block *tc_stats_register (void);
+
+static inline tc_stats_block *tc_stats (void) {
+	return tc_stats_tls ? tc_stats_tls : tc_stats_register();
+}
+
+/* a block is only written by its thread, but read and reset by others:
+ * relaxed atomic accesses are well-defined and compile to plain moves */
+static inline void tc_stats_add (uint64_t * const c, const uint64_t v) {
+	__atomic_store_n(c, __atomic_load_n(c, __ATOMIC_RELAXED) + v, __ATOMIC_RELAXED);
+}
+
+#define TC_STAT(id) do { tc_stats_add(&tc_stats()->count[id], 1); } while (0)
+
+#if defined TIMECODE_INSTRUMENTATION_TSC && (defined __i386__ || defined __x86_64__)
+#include <x86intrin.h>
+#define TC_STATS_TIMING 1
+#define TC_TIMER_BEGIN const uint64_t tc_timer_t0 = __rdtsc();
+#define TC_TIMER_END(id) do { tc_stats_add(&tc_stats()->cycles[id], __rdtsc() - tc_timer_t0); } while (0)
+#else
+#define TC_TIMER_BEGIN
+#define TC_TIMER_END(id) do { } while (0)
+#endif
+
+#else
+
+#define TC_STAT(id) do { } while (0)
+#define TC_TIMER_BEGIN
+#define TC_TIMER_END(id) do { } while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+/*
+   libtimecode - timecode jitter and drift statistics
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "timecode/timecode_sync.h"
+
+/* the statistics are published with a sequence lock: the writer makes the
+ * counter odd, updates the data and makes it even again. Readers copy the
+ * data and retry if the counter was odd or changed meanwhile.
+ */
+#define SNAPSHOT_RETRIES 64
+
+/***** histogram */
+
+/* magnitudes < 16 have their own bucket, larger ones are grouped by
+ * power of two with 8 linear sub-buckets each */
+static int hist_bucket (uint64_t v) {
+	int e;
+	if (v < 16) return (int) v;
+	e = 63 - __builtin_clzll(v);
+	const int b = 16 + (e - 4) * 8 + (int)((v >> (e - 3)) & 7);
+	return b < TIMECODE_SYNC_HIST_BUCKETS ? b : TIMECODE_SYNC_HIST_BUCKETS - 1;
+}
+
+void timecode_sync_bucket_range (const int bucket, int64_t * const lo, int64_t * const hi) {
+	if (bucket < 16) {
+		*lo = *hi = bucket < 0 ? 0 : bucket;
+		return;
+	}
+	const int e = (bucket - 16) / 8 + 4;
+	const int m = (bucket - 16) % 8;
+	*lo = (int64_t)(8 + m) << (e - 3);
+	if (bucket >= TIMECODE_SYNC_HIST_BUCKETS - 1) {
+		*hi = INT64_MAX;
+	} else {
+		*hi = *lo + ((int64_t)1 << (e - 3)) - 1;
+	}
+}
+
+/***** writer */
+
+void timecode_sync_init (TimecodeSyncStats * const s, const double samplerate, const int64_t origin) {
+	memset(s, 0, sizeof(TimecodeSyncStats));
+	s->samplerate = samplerate;
+	s->origin = origin;
+}
+
+int64_t timecode_sync_update (TimecodeSyncStats * const s, const int64_t arrival, TimecodeTime const * const t, TimecodeRate const * const r) {
+	const int64_t offset = arrival - (s->origin + timecode_to_sample(t, r, s->samplerate));
+	const uint32_t seq = s->seq;
+	double n, x, y, dx, dy;
+
+	__atomic_store_n(&s->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	if (s->count == 0) {
+		s->x0 = arrival;
+		s->min = s->max = offset;
+	} else {
+		if (offset < s->min) s->min = offset;
+		if (offset > s->max) s->max = offset;
+	}
+	n = (double) ++s->count;
+
+	/* Welford, extended to the co-moment for the regression slope */
+	x = (double)(arrival - s->x0);
+	y = (double) offset;
+	dx = x - s->mean_x;
+	dy = y - s->mean_y;
+	s->mean_x += dx / n;
+	s->mean_y += dy / n;
+	s->m2_x += dx * (x - s->mean_x);
+	s->m2_y += dy * (y - s->mean_y);
+	s->c_xy += dx * (y - s->mean_y);
+
+	if (offset < 0) {
+		++s->hist[0][hist_bucket(-(uint64_t)offset)];
+	} else {
+		++s->hist[1][hist_bucket((uint64_t)offset)];
+	}
+
+	__atomic_store_n(&s->seq, seq + 2, __ATOMIC_RELEASE);
+	return offset;
+}
+
+/***** reader */
+
+int timecode_sync_snapshot (TimecodeSyncStats const * const s, TimecodeSyncSnapshot * const snap) {
+	int retry;
+	for (retry = 0; retry < SNAPSHOT_RETRIES; ++retry) {
+		const uint32_t seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1) continue;
+
+		const int64_t count = s->count;
+		const double m2_x = s->m2_x;
+		const double m2_y = s->m2_y;
+		const double c_xy = s->c_xy;
+		snap->count = count;
+		snap->mean = s->mean_y;
+		snap->min = s->min;
+		snap->max = s->max;
+		memcpy(snap->hist, s->hist, sizeof(snap->hist));
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) != seq) continue;
+
+		snap->variance = count > 1 ? m2_y / (double)(count - 1) : 0;
+		snap->drift = m2_x > 0 ? c_xy / m2_x : 0;
+		return 0;
+	}
+	return -1;
+}
+
+int64_t timecode_sync_percentile (TimecodeSyncSnapshot const * const snap, const double p) {
+	uint64_t total = 0, rank, sum = 0;
+	int64_t lo, hi;
+	int b;
+	for (b = 0; b < TIMECODE_SYNC_HIST_BUCKETS; ++b) {
+		total += snap->hist[0][b] + (uint64_t)snap->hist[1][b];
+	}
+	if (total == 0) return 0;
+	rank = p <= 0 ? 1 : p >= 100 ? total : (uint64_t)((double)total * p / 100.0 + .5);
+	if (rank < 1) rank = 1;
+
+	for (b = TIMECODE_SYNC_HIST_BUCKETS - 1; b >= 0; --b) {
+		sum += snap->hist[0][b];
+		if (sum >= rank) {
+			timecode_sync_bucket_range(b, &lo, &hi);
+			return -hi;
+		}
+	}
+	for (b = 0; b < TIMECODE_SYNC_HIST_BUCKETS; ++b) {
+		sum += snap->hist[1][b];
+		if (sum >= rank) {
+			timecode_sync_bucket_range(b, &lo, &hi);
+			return hi;
+		}
+	}
+	return snap->max;
+}
@@ -0,0 +1,365 @@
+/*
+   libtimecode - tempo map, Bar Beat Tick time
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "timecode/timecode_tempo.h"
+
+#define TPB TIMECODE_BBT_TICKS_PER_BEAT
+
+typedef struct {
+	TimecodeBBT pos;
+	double bpm;
+} TempoChange;
+
+typedef struct {
+	int32_t bar;
+	int32_t bpb;
+	int32_t type;
+	double qn;     ///< quarter-note position of the bar
+} MeterChange;
+
+/* a range of constant tempo and meter */
+typedef struct {
+	double qn;     ///< start, quarter-notes since 1|1|0
+	double sample; ///< start, samples since 1|1|0
+	double spq;    ///< samples per quarter-note
+	double bar_qn; ///< quarter-note position of the meter's first bar
+	int32_t bar;   ///< first bar of the meter
+	int32_t bpb;   ///< beats per bar
+	int32_t type;  ///< beat type
+} TempoSegment;
+
+struct TimecodeTempoMap {
+	double samplerate;
+
+	TempoChange *tempo;
+	size_t n_tempo;
+	size_t a_tempo;
+
+	MeterChange *meter;
+	size_t n_meter;
+	size_t a_meter;
+
+	TempoSegment *seg;
+	size_t n_seg;
+	size_t a_seg;
+};
+
+/*****************************************************************************
+ * helpers
+ */
+
+static int bbt_cmp(TimecodeBBT const * const a, TimecodeBBT const * const b) {
+	if (a->bar  != b->bar ) return a->bar  > b->bar  ? 1 : -1;
+	if (a->beat != b->beat) return a->beat > b->beat ? 1 : -1;
+	if (a->tick != b->tick) return a->tick > b->tick ? 1 : -1;
+	return 0;
+}
+
+static int grow(void **p, size_t *alloc, const size_t need, const size_t size) {
+	void *n;
+	size_t a = *alloc ? *alloc : 16;
+	if (need <= *alloc) return 0;
+	while (a < need) a *= 2;
+	n = realloc(*p, a * size);
+	if (!n) return -1;
+	*p = n;
+	*alloc = a;
+	return 0;
+}
+
+/* last meter with m->meter[i].bar <= bar */
+static size_t meter_find(TimecodeTempoMap const * const m, const int32_t bar) {
+	size_t lo = 0, hi = m->n_meter;
+	while (hi - lo > 1) {
+		const size_t mid = (lo + hi) / 2;
+		if (m->meter[mid].bar <= bar) lo = mid; else hi = mid;
+	}
+	return lo;
+}
+
+static double meter_bbt_to_qn(int32_t bar, int32_t bpb, int32_t type, double bar_qn, TimecodeBBT const * const bbt) {
+	const double beats = (double)(bbt->bar - bar) * bpb + (bbt->beat - 1) + (double)bbt->tick / TPB;
+	return bar_qn + beats * 4.0 / type;
+}
+
+/* recompute meter positions and the flat segment array */
+static int tempomap_update(TimecodeTempoMap *m) {
+	size_t i, t = 0, k = 0;
+
+	for (i = 1; i < m->n_meter; ++i) {
+		MeterChange const * const p = &m->meter[i - 1];
+		m->meter[i].qn = p->qn + (double)(m->meter[i].bar - p->bar) * p->bpb * 4.0 / p->type;
+	}
+
+	if (grow((void**)&m->seg, &m->a_seg, m->n_tempo + m->n_meter, sizeof(TempoSegment))) {
+		return -1;
+	}
+
+	/* merge tempo and meter changes, both are sorted */
+	m->n_seg = 0;
+	while (t < m->n_tempo || k < m->n_meter) {
+		double tqn = HUGE_VAL;
+		TempoSegment *s = &m->seg[m->n_seg];
+
+		if (t < m->n_tempo) {
+			MeterChange const * const mc = &m->meter[meter_find(m, m->tempo[t].pos.bar)];
+			tqn = meter_bbt_to_qn(mc->bar, mc->bpb, mc->type, mc->qn, &m->tempo[t].pos);
+		}
+
+		if (k < m->n_meter && m->meter[k].qn <= tqn) {
+			s->qn = m->meter[k].qn;
+			if (m->meter[k].qn == tqn) ++t;
+			++k;
+		} else {
+			s->qn = tqn;
+			++t;
+		}
+
+		s->bar    = m->meter[k - 1].bar;
+		s->bpb    = m->meter[k - 1].bpb;
+		s->type   = m->meter[k - 1].type;
+		s->bar_qn = m->meter[k - 1].qn;
+		s->spq    = 60.0 * m->samplerate / m->tempo[t - 1].bpm;
+
+		if (m->n_seg == 0) {
+			s->sample = 0;
+		} else {
+			TempoSegment * const p = &m->seg[m->n_seg - 1];
+			s->sample = p->sample + (s->qn - p->qn) * p->spq;
+			if (p->qn == s->qn) {
+				/* two changes at the same position, the later one takes precedence */
+				*p = *s;
+				continue;
+			}
+		}
+		++m->n_seg;
+	}
+	return 0;
+}
+
+/* last segment that starts at or before qn, try hint first */
+static size_t seg_find_qn(TimecodeTempoMap const * const m, const double qn, size_t hint) {
+	size_t lo = 0, hi = m->n_seg;
+	if (hint < m->n_seg && m->seg[hint].qn <= qn) {
+		if (hint + 1 == m->n_seg || qn < m->seg[hint + 1].qn) return hint;
+		if (hint + 2 == m->n_seg || qn < m->seg[hint + 2].qn) return hint + 1;
+		lo = hint;
+	}
+	while (hi - lo > 1) {
+		const size_t mid = (lo + hi) / 2;
+		if (m->seg[mid].qn <= qn) lo = mid; else hi = mid;
+	}
+	return lo;
+}
+
+static size_t seg_find_sample(TimecodeTempoMap const * const m, const double sample, size_t hint) {
+	size_t lo = 0, hi = m->n_seg;
+	if (hint < m->n_seg && m->seg[hint].sample <= sample) {
+		if (hint + 1 == m->n_seg || sample < m->seg[hint + 1].sample) return hint;
+		if (hint + 2 == m->n_seg || sample < m->seg[hint + 2].sample) return hint + 1;
+		lo = hint;
+	}
+	while (hi - lo > 1) {
+		const size_t mid = (lo + hi) / 2;
+		if (m->seg[mid].sample <= sample) lo = mid; else hi = mid;
+	}
+	return lo;
+}
+
+/* last segment whose meter starts at or before bar */
+static size_t seg_find_bar(TimecodeTempoMap const * const m, const int32_t bar, size_t hint) {
+	size_t lo = 0, hi = m->n_seg;
+	if (hint < m->n_seg && m->seg[hint].bar <= bar) {
+		if (hint + 1 == m->n_seg || bar < m->seg[hint + 1].bar) return hint;
+		lo = hint;
+	}
+	while (hi - lo > 1) {
+		const size_t mid = (lo + hi) / 2;
+		if (m->seg[mid].bar <= bar) lo = mid; else hi = mid;
+	}
+	return lo;
+}
+
+static double bbt_to_sample(TimecodeTempoMap const * const m, TimecodeBBT const * const bbt, size_t *hint) {
+	TempoSegment const *s = &m->seg[seg_find_bar(m, bbt->bar, *hint)];
+	const double qn = meter_bbt_to_qn(s->bar, s->bpb, s->type, s->bar_qn, bbt);
+	*hint = seg_find_qn(m, qn, *hint);
+	s = &m->seg[*hint];
+	return s->sample + (qn - s->qn) * s->spq;
+}
+
+static void sample_to_bbt(TimecodeTempoMap const * const m, TimecodeBBT * const bbt, const double sample, size_t *hint) {
+	TempoSegment const *s;
+	int64_t ticks, tpbar;
+
+	*hint = seg_find_sample(m, sample, *hint);
+	s = &m->seg[*hint];
+
+	ticks = llrint(((s->qn - s->bar_qn) + (sample - s->sample) / s->spq) * s->type / 4.0 * TPB);
+	tpbar = (int64_t) s->bpb * TPB;
+
+	if (ticks < 0) {
+		/* before 1|1|0 */
+		bbt->bar = s->bar - (int32_t)((tpbar - 1 - ticks) / tpbar);
+		ticks -= (int64_t)(bbt->bar - s->bar) * tpbar;
+	} else {
+		bbt->bar = s->bar + (int32_t)(ticks / tpbar);
+		ticks %= tpbar;
+	}
+	bbt->beat = 1 + (int32_t)(ticks / TPB);
+	bbt->tick = (int32_t)(ticks % TPB);
+}
+
+/*****************************************************************************
+ * public API
+ */
+
+TimecodeTempoMap *timecode_tempomap_create (const double samplerate, const double bpm, const int32_t beats_per_bar, const int32_t beat_type) {
+	TimecodeTempoMap *m;
+	TimecodeBBT start = {1, 1, 0};
+	if (samplerate <= 0 || bpm <= 0 || beats_per_bar < 1 || beat_type < 1) {
+		return NULL;
+	}
+	m = (TimecodeTempoMap*) calloc(1, sizeof(TimecodeTempoMap));
+	if (!m) return NULL;
+	m->samplerate = samplerate;
+
+	if (timecode_tempomap_add_meter(m, 1, beats_per_bar, beat_type)
+			|| timecode_tempomap_add_tempo(m, &start, bpm)) {
+		timecode_tempomap_free(m);
+		return NULL;
+	}
+	return m;
+}
+
+void timecode_tempomap_free (TimecodeTempoMap *m) {
+	if (!m) return;
+	free(m->tempo);
+	free(m->meter);
+	free(m->seg);
+	free(m);
+}
+
+int timecode_tempomap_add_tempo (TimecodeTempoMap *m, TimecodeBBT const * const pos, const double bpm) {
+	size_t i;
+	if (bpm <= 0 || pos->bar < 1 || pos->beat < 1 || pos->tick < 0 || pos->tick >= TPB) {
+		return -1;
+	}
+
+	for (i = m->n_tempo; i > 0 && bbt_cmp(&m->tempo[i - 1].pos, pos) > 0; --i) ;
+
+	if (i > 0 && bbt_cmp(&m->tempo[i - 1].pos, pos) == 0) {
+		m->tempo[i - 1].bpm = bpm;
+		return tempomap_update(m);
+	}
+
+	if (grow((void**)&m->tempo, &m->a_tempo, m->n_tempo + 1, sizeof(TempoChange))) {
+		return -1;
+	}
+	memmove(&m->tempo[i + 1], &m->tempo[i], (m->n_tempo - i) * sizeof(TempoChange));
+	m->tempo[i].pos = *pos;
+	m->tempo[i].bpm = bpm;
+	++m->n_tempo;
+
+	if (m->n_meter == 0) return 0;
+	return tempomap_update(m);
+}
+
+int timecode_tempomap_add_meter (TimecodeTempoMap *m, const int32_t bar, const int32_t beats_per_bar, const int32_t beat_type) {
+	size_t i;
+	if (bar < 1 || beats_per_bar < 1 || beat_type < 1) {
+		return -1;
+	}
+
+	for (i = m->n_meter; i > 0 && m->meter[i - 1].bar > bar; --i) ;
+
+	if (i > 0 && m->meter[i - 1].bar == bar) {
+		m->meter[i - 1].bpb  = beats_per_bar;
+		m->meter[i - 1].type = beat_type;
+	} else {
+		if (grow((void**)&m->meter, &m->a_meter, m->n_meter + 1, sizeof(MeterChange))) {
+			return -1;
+		}
+		memmove(&m->meter[i + 1], &m->meter[i], (m->n_meter - i) * sizeof(MeterChange));
+		m->meter[i].bar  = bar;
+		m->meter[i].bpb  = beats_per_bar;
+		m->meter[i].type = beat_type;
+		m->meter[i].qn   = 0;
+		++m->n_meter;
+	}
+
+	if (m->n_tempo == 0) return 0;
+	return tempomap_update(m);
+}
+
+size_t timecode_tempomap_segments (TimecodeTempoMap const * const m) {
+	return m->n_seg;
+}
+
+double timecode_tempomap_bbt_to_seconds (TimecodeTempoMap const * const m, TimecodeBBT const * const bbt) {
+	size_t hint = 0;
+	return bbt_to_sample(m, bbt, &hint) / m->samplerate;
+}
+
+void timecode_tempomap_seconds_to_bbt (TimecodeTempoMap const * const m, TimecodeBBT * const bbt, const double sec) {
+	size_t hint = 0;
+	sample_to_bbt(m, bbt, sec * m->samplerate, &hint);
+}
+
+int64_t timecode_tempomap_bbt_to_sample (TimecodeTempoMap const * const m, TimecodeBBT const * const bbt) {
+	size_t hint = 0;
+	return (int64_t) rint(bbt_to_sample(m, bbt, &hint));
+}
+
+void timecode_tempomap_sample_to_bbt (TimecodeTempoMap const * const m, TimecodeBBT * const bbt, const int64_t sample) {
+	size_t hint = 0;
+	sample_to_bbt(m, bbt, (double) sample, &hint);
+}
+
+void timecode_tempomap_bbt_to_time (TimecodeTempoMap const * const m, TimecodeTime * const t, TimecodeRate const * const r, TimecodeBBT const * const bbt) {
+	timecode_sample_to_time(t, r, m->samplerate, timecode_tempomap_bbt_to_sample(m, bbt));
+}
+
+void timecode_tempomap_time_to_bbt (TimecodeTempoMap const * const m, TimecodeBBT * const bbt, TimecodeTime const * const t, TimecodeRate const * const r) {
+	timecode_tempomap_sample_to_bbt(m, bbt, timecode_to_sample(t, r, m->samplerate));
+}
+
+void timecode_tempomap_bbt_to_sample_batch (TimecodeTempoMap const * const m, int64_t * const out, TimecodeBBT const * const in, const size_t n) {
+	size_t i, hint = 0;
+	for (i = 0; i < n; ++i) {
+		out[i] = (int64_t) rint(bbt_to_sample(m, &in[i], &hint));
+	}
+}
+
+void timecode_tempomap_sample_to_bbt_batch (TimecodeTempoMap const * const m, TimecodeBBT * const out, int64_t const * const in, const size_t n) {
+	size_t i, hint = 0;
+	for (i = 0; i < n; ++i) {
+		sample_to_bbt(m, &out[i], (double) in[i], &hint);
+	}
+}
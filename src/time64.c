@@ -0,0 +1,169 @@
+/*
+   libtimecode - 64-bit timecode for high rates and long durations
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "timecode/timecode_time64.h"
+#include "internal.h"
+
+#define NS_PER_SEC 1000000000LL
+
+/* division rounding towards negative infinity, d > 0 */
+static inline int64_t floordiv (const int64_t n, const int64_t d) {
+	const int64_t q = n / d;
+	return (n % d < 0) ? q - 1 : q;
+}
+
+static inline int64_t subframes_per_frame (TimecodeRate const * const r) {
+	return r->subframes > 0 ? r->subframes : 1;
+}
+
+/***** widen / narrow */
+
+void timecode_time_to_time64 (TimecodeTime64 * const t64, TimecodeTime const * const t) {
+	t64->hour     = t->hour;
+	t64->minute   = t->minute;
+	t64->second   = t->second;
+	t64->frame    = t->frame;
+	t64->subframe = t->subframe;
+}
+
+int64_t timecode_time64_to_time (TimecodeTime * const t, TimecodeTime64 const * const t64) {
+	const int64_t days = floordiv(t64->hour, 24);
+	t->hour     = t64->hour - 24 * days;
+	t->minute   = t64->minute;
+	t->second   = t64->second;
+	t->frame    = t64->frame;
+	t->subframe = t64->subframe;
+	return days;
+}
+
+/***** frames, subframes */
+
+int64_t timecode_time64_to_framenumber (TimecodeTime64 const * const t, TimecodeRate const * const r) {
+	const int64_t fps_i = TC_FPS_I(r);
+	int64_t frames = fps_i * (3600 * t->hour + 60 * t->minute + t->second) + t->frame;
+	if (r->drop) {
+		const int64_t totalMinutes = 60 * t->hour + t->minute;
+		frames -= 2 * (totalMinutes - floordiv(totalMinutes, 10));
+	}
+	return frames;
+}
+
+void timecode_framenumber_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, int64_t frameno) {
+	const int64_t fps_i = TC_FPS_I(r);
+	if (r->drop) {
+		const int64_t f10 = 600 * fps_i - 18;
+		const int64_t f1  =  60 * fps_i - 2;
+		const int64_t D = floordiv(frameno, f10);
+		const int64_t M = frameno - D * f10;
+		frameno += 18 * D + 2 * ((M - 2) / f1);
+	}
+	const int64_t sec = floordiv(frameno, fps_i);
+	t->frame    = frameno - sec * fps_i;
+	t->hour     = floordiv(sec, 3600);
+	t->minute   = (sec - 3600 * t->hour) / 60;
+	t->second   = (sec - 3600 * t->hour) % 60;
+	t->subframe = 0;
+}
+
+int64_t timecode_time64_to_subframes (TimecodeTime64 const * const t, TimecodeRate const * const r) {
+	return timecode_time64_to_framenumber(t, r) * subframes_per_frame(r) + (r->subframes > 0 ? t->subframe : 0);
+}
+
+void timecode_subframes_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const int64_t subframes) {
+	const int64_t sf = subframes_per_frame(r);
+	const int64_t frames = floordiv(subframes, sf);
+	timecode_framenumber_to_time64(t, r, frames);
+	t->subframe = subframes - frames * sf;
+}
+
+/***** samples, ticks, nanoseconds */
+
+int64_t timecode_time64_to_sample (TimecodeTime64 const * const t, TimecodeRate const * const r, const int32_t samplerate) {
+	return tc_muldiv_rnd(timecode_time64_to_subframes(t, r),
+			(int64_t) r->den * samplerate, (int64_t) r->num * subframes_per_frame(r), TIMECODE_ROUND_NEAREST);
+}
+
+void timecode_sample_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const int32_t samplerate, const int64_t sample) {
+	timecode_subframes_to_time64(t, r, tc_muldiv_rnd(sample,
+				(int64_t) r->num * subframes_per_frame(r), (int64_t) r->den * samplerate, TIMECODE_ROUND_NEAREST));
+}
+
+TimecodeTicks timecode_time64_to_ticks (TimecodeTime64 const * const t, TimecodeRate const * const r) {
+	return tc_muldiv_rnd(timecode_time64_to_subframes(t, r),
+			(int64_t) TIMECODE_TICKS_PER_SECOND * r->den, (int64_t) r->num * subframes_per_frame(r), TIMECODE_ROUND_UP);
+}
+
+void timecode_ticks_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const TimecodeTicks ticks) {
+	timecode_subframes_to_time64(t, r, tc_muldiv_rnd(ticks,
+				(int64_t) r->num * subframes_per_frame(r), (int64_t) TIMECODE_TICKS_PER_SECOND * r->den, TIMECODE_ROUND_DOWN));
+}
+
+int64_t timecode_time64_to_ns (TimecodeTime64 const * const t, TimecodeRate const * const r) {
+	return tc_muldiv_rnd(timecode_time64_to_subframes(t, r),
+			NS_PER_SEC * r->den, (int64_t) r->num * subframes_per_frame(r), TIMECODE_ROUND_NEAREST);
+}
+
+void timecode_ns_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const int64_t ns) {
+	timecode_subframes_to_time64(t, r, tc_muldiv_rnd(ns,
+				(int64_t) r->num * subframes_per_frame(r), NS_PER_SEC * r->den, TIMECODE_ROUND_NEAREST));
+}
+
+/***** arithmetic */
+
+void timecode_time64_add (TimecodeTime64 * const res, TimecodeRate const * const r, TimecodeTime64 const * const t1, TimecodeTime64 const * const t2) {
+	const int64_t s = timecode_time64_to_subframes(t1, r) + timecode_time64_to_subframes(t2, r);
+	timecode_subframes_to_time64(res, r, s);
+}
+
+void timecode_time64_subtract (TimecodeTime64 * const res, TimecodeRate const * const r, TimecodeTime64 const * const t1, TimecodeTime64 const * const t2) {
+	const int64_t s = timecode_time64_to_subframes(t1, r) - timecode_time64_to_subframes(t2, r);
+	timecode_subframes_to_time64(res, r, s);
+}
+
+int timecode_time64_compare (TimecodeTime64 const * const a, TimecodeTime64 const * const b) {
+	if (a->hour     != b->hour    ) return a->hour     > b->hour     ? 1 : -1;
+	if (a->minute   != b->minute  ) return a->minute   > b->minute   ? 1 : -1;
+	if (a->second   != b->second  ) return a->second   > b->second   ? 1 : -1;
+	if (a->frame    != b->frame   ) return a->frame    > b->frame    ? 1 : -1;
+	if (a->subframe != b->subframe) return a->subframe > b->subframe ? 1 : -1;
+	return (0);
+}
+
+/***** string */
+
+size_t timecode_time64_to_string (char *str, const size_t maxsize, TimecodeTime64 const * const t, TimecodeRate const * const r) {
+	int n;
+	if (r->subframes > 0) {
+		n = snprintf(str, maxsize, "%02" PRId64 ":%02" PRId64 ":%02" PRId64 ":%02" PRId64 ".%" PRId64,
+				t->hour, t->minute, t->second, t->frame, t->subframe);
+	} else {
+		n = snprintf(str, maxsize, "%02" PRId64 ":%02" PRId64 ":%02" PRId64 ":%02" PRId64,
+				t->hour, t->minute, t->second, t->frame);
+	}
+	return n < 0 ? 0 : (size_t) n;
+}
@@ -32,6 +32,11 @@
 #include <math.h>
 
 #include "timecode/timecode.h"
+#include "internal.h"
+#include "stats.h"
+
+#define TIMECODE_INLINE_SLOWPATH(id) TC_STAT(TIMECODE_STAT_##id)
+#include "timecode/timecode_inline.h"
 
 /*****************************************************************************
  * Constants
@@ -39,6 +44,10 @@
 
 /* TODO: subframe default, use 80, 100 or 384 or 600 or 5760,.. or 500000
  * 84672000 = LCM(192k, 88.2k, 24, 25, 30)
+ *
+ * For sample-accurate integer math use TimecodeTicks,
+ * TIMECODE_TICKS_PER_SECOND = 1411200000 is a multiple of all common
+ * sample rates, 90k and 24, 25, 30, 48, 50, 60 * 1000/1001.
  */
 
 const TimecodeRate tcfps23976   = { 24000, 1001, 0, 80};
@@ -85,84 +94,18 @@ double timecode_frames_per_timecode_frame(TimecodeRate const * const r, const do
  */
 
 int64_t timecode_to_sample (TimecodeTime const * const t, TimecodeRate const * const r, const double samplerate) {
-	const double  fps_d = TCtoDbl(r);
-	const int64_t fps_i = ceil(fps_d);
-	const double frames_per_timecode_frame = samplerate / fps_d;
-	int64_t sample;
-
-	if (r->drop) {
-		int64_t totalMinutes = 60 * t->hour + t->minute;
-		int64_t frameNumber  = fps_i * 3600 * t->hour + fps_i * 60 * t->minute
-			                 + fps_i * t->second + t->frame
-					 - 2 * (totalMinutes - totalMinutes / 10);
-
-		sample = floor (frameNumber * (samplerate / fps_d));
-	} else {
-		sample = (int64_t) rint(
-				(
-				   ((t->hour * 60 * 60) + (t->minute * 60) + t->second)
-				 * (fps_i * frames_per_timecode_frame)
-				)
-				 + (t->frame * frames_per_timecode_frame));
-	}
-	if (r->subframes != 0) {
-		sample += rint((double)t->subframe * frames_per_timecode_frame / (double)r->subframes);
-	}
+	TC_TIMER_BEGIN
+	TC_STAT(TIMECODE_STAT_TO_SAMPLE);
+	const int64_t sample = timecode_inline_to_sample(t, r, samplerate);
+	TC_TIMER_END(TIMECODE_STAT_TO_SAMPLE);
 	return sample;
 }
 
 void timecode_sample_to_time (TimecodeTime * const t, TimecodeRate const * const r, const double samplerate, const int64_t sample) {
-	const double  fps_d = TCtoDbl(r);
-	const int64_t fps_i = ceil(fps_d);
-
-	if (r->drop) {
-		int64_t frameNumber = floor( (double)sample * fps_d / samplerate );
-
-		/* there are 17982 frames in 10 min @ 29.97df */
-		const int64_t D = frameNumber / 17982;
-		const int64_t M = frameNumber % 17982;
-
-		t->subframe =  rint(r->subframes * ((double)sample * fps_d / samplerate - (double)frameNumber));
-
-		if (t->subframe == r->subframes && r->subframes != 0) {
-			t->subframe = 0;
-			frameNumber++;
-		}
-
-		frameNumber +=  18*D + 2*((M - 2) / 1798);
-
-		t->frame  =    frameNumber % 30;
-		t->second =   (frameNumber / 30) % 60;
-		t->minute =  ((frameNumber / 30) / 60) % 60;
-		t->hour   = (((frameNumber / 30) / 60) / 60);
-
-	} else {
-		double timecode_frames_left_exact;
-		double timecode_frames_fraction;
-		int64_t timecode_frames_left;
-		const double frames_per_timecode_frame = samplerate / fps_d;
-		const int64_t frames_per_hour = (int64_t)(3600 * fps_i * frames_per_timecode_frame);
-
-		t->hour = sample / frames_per_hour;
-		double sample_d = sample % frames_per_hour;
-
-		timecode_frames_left_exact = sample_d / frames_per_timecode_frame;
-		timecode_frames_fraction = timecode_frames_left_exact - floor( timecode_frames_left_exact );
-
-		t->subframe = (int32_t) rint(timecode_frames_fraction * r->subframes);
-
-		timecode_frames_left = (int64_t) floor (timecode_frames_left_exact);
-
-		if (t->subframe == r->subframes && r->subframes != 0) {
-			t->subframe = 0;
-			timecode_frames_left++;
-		}
-
-		t->minute = timecode_frames_left / (fps_i * 60);
-		timecode_frames_left = timecode_frames_left % (fps_i * 60);
-		t->second = timecode_frames_left / fps_i;
-		t->frame  = timecode_frames_left % fps_i;
-	}
+	TC_TIMER_BEGIN
+	TC_STAT(TIMECODE_STAT_SAMPLE_TO_TIME);
+	timecode_inline_sample_to_time(t, r, samplerate, sample);
+	TC_TIMER_END(TIMECODE_STAT_SAMPLE_TO_TIME);
 }
 
 int64_t timecode_to_framenumber (TimecodeTime const * const t, TimecodeRate const * const r) {
@@ -177,8 +120,11 @@ void timecode_convert_rate (TimecodeTime * const t_out, TimecodeRate const * con
 	//const double rate = 84672000; // LCM(192k, 88.2k, 24, 25, 30)
 	//const double rate = TCtoDbl(r_out) < TCtoDbl(r_in) ? (TCtoDbl(r_in) * r_in->subframes) : (TCtoDbl(r_out) * r_out->subframes);
 	const double rate = TCtoDbl(r_out) < TCtoDbl(r_in) ?  TCtoDbl(r_in) :  TCtoDbl(r_out);
+	TC_TIMER_BEGIN
+	TC_STAT(TIMECODE_STAT_CONVERT_RATE);
 	int64_t s = timecode_to_sample(t_in, r_in, rate);
 	timecode_sample_to_time(t_out, r_out, rate, s);
+	TC_TIMER_END(TIMECODE_STAT_CONVERT_RATE);
 }
 
 /*****************************************************************************
@@ -213,11 +159,304 @@ double timecode_to_sec (TimecodeTime const * const t, TimecodeRate const * const
 }
 
 
+/*****************************************************************************
+ * integer ticks
+ */
+
+TimecodeTicks timecode_time_to_ticks (TimecodeTime const * const t, TimecodeRate const * const r) {
+	const int64_t sf = r->subframes > 0 ? r->subframes : 1;
+	const int64_t s = tc_time_to_frames(t, r) * sf + (r->subframes > 0 ? t->subframe : 0);
+	return tc_muldiv_rnd(s, (int64_t) TIMECODE_TICKS_PER_SECOND * r->den, r->num * sf, TIMECODE_ROUND_UP);
+}
+
+void timecode_ticks_to_time (TimecodeTime * const t, TimecodeRate const * const r, const TimecodeTicks ticks) {
+	const int64_t sf = r->subframes > 0 ? r->subframes : 1;
+	const int64_t s = tc_muldiv_floor(ticks, r->num * sf, (int64_t) TIMECODE_TICKS_PER_SECOND * r->den);
+	int64_t frames = s / sf;
+	int64_t sub = s % sf;
+	if (sub < 0) {
+		sub += sf;
+		--frames;
+	}
+	tc_frames_to_time(t, r, frames);
+	t->subframe = (r->subframes > 0) ? sub : 0;
+}
+
+TimecodeTicks timecode_sample_to_ticks (const int64_t sample, const int32_t samplerate) {
+	return tc_muldiv_floor(sample, TIMECODE_TICKS_PER_SECOND, samplerate);
+}
+
+int64_t timecode_ticks_to_sample (const TimecodeTicks ticks, const int32_t samplerate) {
+	return tc_muldiv_floor(ticks, samplerate, TIMECODE_TICKS_PER_SECOND);
+}
+
+TimecodeTicks timecode_framenumber_to_ticks (const int64_t frameno, TimecodeRate const * const r) {
+	return tc_muldiv_floor(frameno, (int64_t) TIMECODE_TICKS_PER_SECOND * r->den, r->num);
+}
+
+int64_t timecode_ticks_to_framenumber (const TimecodeTicks ticks, TimecodeRate const * const r) {
+	return tc_muldiv_floor(ticks, r->num, (int64_t) TIMECODE_TICKS_PER_SECOND * r->den);
+}
+
+/*****************************************************************************
+ * nanoseconds since the epoch
+ */
+
+#define NS_PER_SEC 1000000000LL
+#define NS_PER_DAY (86400LL * NS_PER_SEC)
+
+/* reduced scale between subframe units and nanoseconds:
+ * ns = s * n / d, s = ns * d / n */
+typedef struct {
+	int64_t n;
+	int64_t d;
+	int64_t s_max;  ///< largest s for which s * n does not overflow
+	int64_t ns_max; ///< largest ns for which ns * d does not overflow
+	int64_t sf;     ///< subframes per frame, at least 1
+} epoch_scale;
+
+static void epoch_scale_init (epoch_scale * const e, TimecodeRate const * const r) {
+	int64_t g;
+	e->sf = r->subframes > 0 ? r->subframes : 1;
+	e->n = r->den * NS_PER_SEC;
+	e->d = r->num * e->sf;
+	g = tc_gcd(e->n, e->d);
+	e->n /= g;
+	e->d /= g;
+	e->s_max = (INT64_MAX - e->d) / e->n;
+	e->ns_max = INT64_MAX / e->d - 1;
+}
+
+static inline int64_t epoch_to_ns (epoch_scale const * const e, Timecode const * const tc) {
+	const int64_t days = tc->d.month ? tc_days_from_civil(tc->d.year, tc->d.month, tc->d.day) : 0;
+	const int64_t s = tc_time_to_frames(&tc->t, &tc->r) * e->sf + (tc->r.subframes > 0 ? tc->t.subframe : 0);
+	int64_t ns;
+	if (s >= 0 && s <= e->s_max) {
+		ns = (s * e->n + e->d - 1) / e->d;
+	} else {
+		/* round up */
+		ns = -tc_muldiv_floor(-s, e->n, e->d);
+	}
+	return days * NS_PER_DAY - tc->d.timezone * 60 * NS_PER_SEC + ns;
+}
+
+static inline void epoch_from_ns (epoch_scale const * const e, Timecode * const tc, TimecodeRate const * const r, const int32_t timezone, const int64_t ns) {
+	const int64_t local = ns + timezone * 60 * NS_PER_SEC;
+	int64_t days = local / NS_PER_DAY;
+	int64_t rem = local % NS_PER_DAY;
+	int64_t s;
+	if (rem < 0) {
+		rem += NS_PER_DAY;
+		--days;
+	}
+	if (rem <= e->ns_max) {
+		s = rem * e->d / e->n;
+	} else {
+		s = tc_muldiv_floor(rem, e->d, e->n);
+	}
+	tc_frames_to_time(&tc->t, r, s / e->sf);
+	tc->t.subframe = (r->subframes > 0) ? s % e->sf : 0;
+	tc_civil_from_days(&tc->d, days);
+	tc->d.timezone = timezone;
+	tc->r = *r;
+}
+
+int64_t timecode_datetime_to_epoch_ns (Timecode const * const tc) {
+	epoch_scale e;
+	epoch_scale_init(&e, &tc->r);
+	return epoch_to_ns(&e, tc);
+}
+
+void timecode_epoch_ns_to_datetime (Timecode * const tc, TimecodeRate const * const r, const int32_t timezone, const int64_t ns) {
+	epoch_scale e;
+	epoch_scale_init(&e, r);
+	epoch_from_ns(&e, tc, r, timezone, ns);
+}
+
+void timecode_datetime_to_epoch_ns_batch (int64_t * const out, Timecode const * const in, const size_t n) {
+	epoch_scale e;
+	TimecodeRate r = {0, 0, 0, 0};
+	size_t i;
+	for (i = 0; i < n; ++i) {
+		if (in[i].r.num != r.num || in[i].r.den != r.den || in[i].r.subframes != r.subframes) {
+			r = in[i].r;
+			epoch_scale_init(&e, &r);
+		}
+		out[i] = epoch_to_ns(&e, &in[i]);
+	}
+}
+
+void timecode_epoch_ns_to_datetime_batch (Timecode * const out, TimecodeRate const * const r, const int32_t timezone, int64_t const * const in, const size_t n) {
+	epoch_scale e;
+	size_t i;
+	epoch_scale_init(&e, r);
+	for (i = 0; i < n; ++i) {
+		epoch_from_ns(&e, &out[i], r, timezone, in[i]);
+	}
+}
+
+/*****************************************************************************
+ * rational remapping
+ */
+
+int64_t timecode_remap_sample (const int64_t sample, const int32_t num, const int32_t den) {
+	return tc_muldiv_round(sample, num, den);
+}
+
+void timecode_remap_samples (int64_t * const out, int64_t const * const in, const size_t n, const int32_t num, const int32_t den) {
+	const int64_t g = tc_gcd(num, den);
+	const int64_t rn = num / g;
+	const int64_t rd = den / g;
+	size_t i;
+
+	if (rd == 1) {
+		for (i = 0; i < n; ++i) {
+			out[i] = in[i] * rn;
+		}
+		return;
+	}
+
+	for (i = 0; i < n; ++i) {
+		out[i] = tc_muldiv_round(in[i], rn, rd);
+	}
+}
+
+/* multiply a rational n/d by f/1 or 1/f, keeping it reduced */
+static void rat_mul(int64_t *n, int64_t *d, int64_t fn, int64_t fd) {
+	int64_t g = tc_gcd(fn, *d);
+	fn /= g; *d /= g;
+	g = tc_gcd(fd, *n);
+	fd /= g; *n /= g;
+	*n *= fn;
+	*d *= fd;
+}
+
+void timecode_remap_time (TimecodeTime * const t_out, TimecodeRate const * const r_out, TimecodeTime const * const t_in, TimecodeRate const * const r_in, const int32_t num, const int32_t den) {
+	const int64_t sfi = r_in->subframes > 0 ? r_in->subframes : 1;
+	const int64_t sfo = r_out->subframes > 0 ? r_out->subframes : 1;
+	int64_t n = 1, d = 1;
+	int64_t s;
+
+	/* subframe units of r_in -> seconds -> scaled -> subframe units of r_out */
+	rat_mul(&n, &d, r_in->den, r_in->num);
+	rat_mul(&n, &d, 1, sfi);
+	rat_mul(&n, &d, num, den);
+	rat_mul(&n, &d, r_out->num, r_out->den);
+	rat_mul(&n, &d, sfo, 1);
+
+	s = tc_time_to_frames(t_in, r_in) * sfi + (r_in->subframes > 0 ? t_in->subframe : 0);
+	s = tc_muldiv_round(s, n, d);
+
+	tc_frames_to_time(t_out, r_out, s / sfo);
+	t_out->subframe = (r_out->subframes > 0) ? s % sfo : 0;
+}
+
+/*****************************************************************************
+ * container timestamps
+ */
+
+/* subframe units of r -> seconds -> time base units, reduced */
+static void pts_scale (int64_t *n, int64_t *d, int64_t *sf, TimecodeRate const * const r, const int32_t tb_num, const int32_t tb_den) {
+	*sf = r->subframes > 0 ? r->subframes : 1;
+	*n = 1;
+	*d = 1;
+	rat_mul(n, d, r->den, r->num);
+	rat_mul(n, d, 1, *sf);
+	rat_mul(n, d, tb_den, tb_num);
+}
+
+static inline int64_t pts_from_time (TimecodeTime const * const t, TimecodeRate const * const r, const int64_t n, const int64_t d, const int64_t sf, const TimecodeRounding rnd) {
+	const int64_t s = tc_time_to_frames(t, r) * sf + (r->subframes > 0 ? t->subframe : 0);
+	if (d == 1) return s * n;
+	return tc_muldiv_rnd(s, n, d, rnd);
+}
+
+static inline void pts_to_time (TimecodeTime * const t, TimecodeRate const * const r, const int64_t pts, const int64_t n, const int64_t d, const int64_t sf, const TimecodeRounding rnd) {
+	const int64_t s = (n == 1) ? pts * d : tc_muldiv_rnd(pts, d, n, rnd);
+	tc_frames_to_time(t, r, s / sf);
+	t->subframe = (r->subframes > 0) ? s % sf : 0;
+}
+
+int64_t timecode_time_to_pts (TimecodeTime const * const t, TimecodeRate const * const r, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd) {
+	int64_t n, d, sf;
+	pts_scale(&n, &d, &sf, r, tb_num, tb_den);
+	return pts_from_time(t, r, n, d, sf, rnd);
+}
+
+void timecode_pts_to_time (TimecodeTime * const t, TimecodeRate const * const r, const int64_t pts, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd) {
+	int64_t n, d, sf;
+	pts_scale(&n, &d, &sf, r, tb_num, tb_den);
+	pts_to_time(t, r, pts, n, d, sf, rnd);
+}
+
+void timecode_time_to_pts_batch (int64_t * const out, TimecodeTime const * const in, const size_t n, TimecodeRate const * const r, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd) {
+	int64_t sn, sd, sf;
+	size_t i;
+	pts_scale(&sn, &sd, &sf, r, tb_num, tb_den);
+	for (i = 0; i < n; ++i) {
+		out[i] = pts_from_time(&in[i], r, sn, sd, sf, rnd);
+	}
+}
+
+void timecode_pts_to_time_batch (TimecodeTime * const out, int64_t const * const in, const size_t n, TimecodeRate const * const r, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd) {
+	int64_t sn, sd, sf;
+	size_t i;
+	pts_scale(&sn, &sd, &sf, r, tb_num, tb_den);
+	for (i = 0; i < n; ++i) {
+		pts_to_time(&out[i], r, in[i], sn, sd, sf, rnd);
+	}
+}
+
+/*****************************************************************************
+ * frame boundaries
+ */
+
+static inline int64_t boundary_frame (TimecodeTime * const t, TimecodeRate const * const r, const double samplerate, const int64_t sample) {
+	timecode_inline_sample_to_time(t, r, samplerate, sample);
+	return tc_time_to_frames(t, r);
+}
+
+size_t timecode_frame_boundaries (TimecodeRate const * const r, const double samplerate, const int64_t start, const size_t nframes, size_t * const offsets, TimecodeTime * const tc, const size_t max) {
+	const double spf = samplerate * (double)r->den / (double)r->num;
+	/* with subframes, the frame changes where the subframe rounds up */
+	const double early = r->subframes > 0 ? .5 / r->subframes : 0;
+	const int64_t end = start + (int64_t)nframes;
+	TimecodeTime t;
+	int64_t k, c, f;
+	size_t n = 0;
+
+	if (start > 0) {
+		k = boundary_frame(&t, r, samplerate, start - 1) + 1;
+	} else {
+		k = 0;
+	}
+
+	while (n < max) {
+		/* estimate the first sample of frame k, then correct floating-point
+		 * rounding against the reference */
+		c = (int64_t) ceil (((double)k - early) * spf);
+		if (c < start) c = start;
+		if (c >= end) break;
+		while (c > start && boundary_frame(&t, r, samplerate, c - 1) >= k) {
+			--c;
+		}
+		while ((f = boundary_frame(&t, r, samplerate, c)) < k) {
+			if (++c >= end) break;
+		}
+		if (c >= end) break;
+		if (offsets) offsets[n] = c - start;
+		if (tc) tc[n] = t;
+		++n;
+		k = f + 1;
+	}
+	return n;
+}
+
 /*****************************************************************************
  * Add Subtract
  */
 
-static int32_t timecode_move_time_overflow(TimecodeTime * const t, TimecodeRate const * const r) {
+int32_t tc_move_time_overflow(TimecodeTime * const t, TimecodeRate const * const r) {
 	int i;
 	int32_t rv = 0;
 	int32_t * const bcd[6] = {&t->subframe, &t->frame, &t->second, &t->minute, &t->hour, &rv };
@@ -229,6 +468,7 @@ static int32_t timecode_move_time_overflow(TimecodeTime * const t, TimecodeRate
 	for (i=0; i<5; i++) {
 		if ((*bcd[i] >= smpte_table[i]) || (*bcd[i] < 0) ) {
 			if (smpte_table[i] == 0) continue;
+			TC_STAT(TIMECODE_STAT_OVERFLOW);
 			int ov= (int) floor((double) (*bcd[i]) / smpte_table[i]);
 #if 0
 			// TODO drop-frames ? - basically only needed when parsing invalid TC
@@ -298,7 +538,10 @@ static int32_t dropped_frames(TimecodeTime const * const t) {
 
 void timecode_time_add (TimecodeTime * const res, TimecodeRate const * const r, TimecodeTime const * const t1, TimecodeTime const * const t2) {
 	int df = 0;
+	TC_TIMER_BEGIN
+	TC_STAT(TIMECODE_STAT_TIME_ADD);
 	if (r->drop) {
+		TC_STAT(TIMECODE_STAT_DROPFRAME);
 		df = dropped_frames(t1) + dropped_frames(t2);
 	}
 
@@ -309,16 +552,20 @@ void timecode_time_add (TimecodeTime * const res, TimecodeRate const * const r,
 	res->hour     = t1->hour     + t2->hour    ;
 
 	if (r->drop) {
-		timecode_move_time_overflow(res, r);
+		tc_move_time_overflow(res, r);
 		res->frame += dropped_frames(res) - df;
 	}
 
-	timecode_move_time_overflow(res, r);
+	tc_move_time_overflow(res, r);
+	TC_TIMER_END(TIMECODE_STAT_TIME_ADD);
 }
 
 void timecode_time_subtract (TimecodeTime * const res, TimecodeRate const * const r, TimecodeTime const * const t1, TimecodeTime const * const t2) {
 	int df = 0;
+	TC_TIMER_BEGIN
+	TC_STAT(TIMECODE_STAT_TIME_SUBTRACT);
 	if (r->drop) {
+		TC_STAT(TIMECODE_STAT_DROPFRAME);
 		df = dropped_frames(t1) - dropped_frames(t2);
 	}
 
@@ -329,21 +576,18 @@ void timecode_time_subtract (TimecodeTime * const res, TimecodeRate const * cons
 	res->hour     = t1->hour     - t2->hour    ;
 
 	if (r->drop) {
-		timecode_move_time_overflow(res, r);
+		tc_move_time_overflow(res, r);
 		res->frame += dropped_frames(res) - df;
 	}
 
-	timecode_move_time_overflow(res, r);
+	tc_move_time_overflow(res, r);
+	TC_TIMER_END(TIMECODE_STAT_TIME_SUBTRACT);
 }
 
 #define CMP(a,b) ( (a) > (b) ? 1 : -1)
 int timecode_time_compare (TimecodeRate const * const r, TimecodeTime const * const a, TimecodeTime const * const b) {
-	if (a->hour     != b->hour    ) return CMP(a->hour, b->hour);
-	if (a->minute   != b->minute  ) return CMP(a->minute, b->minute);
-	if (a->second   != b->second  ) return CMP(a->second, b->second);
-	if (a->frame    != b->frame   ) return CMP(a->frame, b->frame);
-	if (a->subframe != b->subframe) return CMP(a->subframe, b->subframe);
-	return (0);
+	TC_STAT(TIMECODE_STAT_TIME_COMPARE);
+	return timecode_inline_time_compare(r, a, b);
 }
 
 int timecode_date_compare (TimecodeDate const * const a, TimecodeDate const * const b) {
@@ -366,8 +610,8 @@ int timecode_datetime_compare (TimecodeRate const * const r, Timecode const * co
 	ax.d.timezone = bx.d.timezone = 0;
 
 	/* adjust day, month */
-	int ao = timecode_move_time_overflow(&ax.t, r);
-	int bo = timecode_move_time_overflow(&bx.t, r);
+	int ao = tc_move_time_overflow(&ax.t, r);
+	int bo = tc_move_time_overflow(&bx.t, r);
 
 	if (ao < 0) {
 		int i;
@@ -422,27 +666,10 @@ void timecode_date_increment(TimecodeDate * const d) {
 }
 
 int timecode_time_increment(TimecodeTime * const t, TimecodeRate const * const r) {
-	int rv = 0;
-	const int fps = ceil(TCtoDbl(r));
-	t->frame++;
-
-	if (t->frame < fps) goto done;
-	t->frame = 0;
-	t->second++;
-	if (t->second < 60) goto done;
-	t->second = 0;
-	t->minute++;
-	if (t->minute < 60) goto done;
-	t->minute = 0;
-	t->hour++;
-	if (t->hour < 24) goto done;
-	t->hour = 0;
-	rv=1;
-
-done:
-	if (r->drop && (t->minute%10 != 0) && (t->second == 0) && (t->frame == 0)) {
-		t->frame += 2;
-	}
+	TC_TIMER_BEGIN
+	TC_STAT(TIMECODE_STAT_TIME_INCREMENT);
+	const int rv = timecode_inline_time_increment(t, r);
+	TC_TIMER_END(TIMECODE_STAT_TIME_INCREMENT);
 	return rv;
 }
 
@@ -465,37 +692,8 @@ void timecode_date_decrement (TimecodeDate * const d) {
 }
 
 int timecode_time_decrement(TimecodeTime * const t, TimecodeRate const * const r) {
-	const int fps = ceil(TCtoDbl(r));
-
-	if (r->drop && (t->minute%10 != 0) && (t->second == 0) && (t->frame == 2)) {
-		; // assume t->frame==0;
-	} else
-
-	if (t->frame > 0) {
-		t->frame--;
-		return 0;
-	}
-
-	t->frame = fps-1;
-	if (t->second > 0) {
-		t->second--;
-		return 0;
-	}
-
-	t->second = 59;
-	if (t->minute > 0) {
-		t->minute--;
-		return 0;
-	}
-
-	t->minute = 59;
-	if (t->hour > 0) {
-		t->hour--;
-		return 0;
-	}
-	t->hour = 23;
-
-	return 1;
+	TC_STAT(TIMECODE_STAT_TIME_DECREMENT);
+	return timecode_inline_time_decrement(t, r);
 }
 
 int timecode_datetime_increment (Timecode * const dt) {
@@ -670,6 +868,8 @@ int32_t timecode_parse_time (TimecodeTime * const t, TimecodeRate const * const
 	char *buf = strdup(val);
 	char *pe;
 	int32_t * const bcd[5] = {&t->frame, &t->second, &t->minute, &t->hour, NULL };
+	TC_TIMER_BEGIN
+	TC_STAT(TIMECODE_STAT_PARSE_TIME);
 
 	t->subframe = 0;
 	for (i=0; i<4; i++) {
@@ -694,12 +894,13 @@ int32_t timecode_parse_time (TimecodeTime * const t, TimecodeRate const * const
 
 	free(buf);
 
-	int32_t rv = timecode_move_time_overflow(t, r);
+	int32_t rv = tc_move_time_overflow(t, r);
 
 	if (r->drop && (t->minute%10 != 0) && (t->second == 0) && (t->frame == 0)) {
 		t->frame=2;
 	}
 
+	TC_TIMER_END(TIMECODE_STAT_PARSE_TIME);
 	return rv;
 }
 
@@ -738,11 +939,9 @@ void timecode_parse_framerate (TimecodeRate * const r, const char *val, int flag
 
 	if (!(flags & 8)) {
 		if (strstr(val, "ndf")) {
-			printf("NDF\n");
 			r->drop = 0;
 			flags &= ~1;
 		} else if (strstr(val, "df")) {
-			printf("DF\n");
 			r->drop = 1;
 			flags &= ~1;
 		}
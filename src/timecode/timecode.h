@@ -58,6 +58,36 @@ typedef long long int int64_t;
 #endif
 #endif
 
+/**
+ * integer time, counted in units of 1/\ref TIMECODE_TICKS_PER_SECOND seconds.
+ *
+ * Arithmetic and comparison are plain integer operations.
+ */
+typedef int64_t TimecodeTicks;
+
+/**
+ * number of \ref TimecodeTicks per second:
+ * 1411200000 = 2^10 * 3^2 * 5^5 * 7^2.
+ *
+ * Frames at 24, 25, 30, 48, 50, 60 fps and their 1001 variants, as well as
+ * samples at 8k, 11.025k, 16k, 22.05k, 32k, 44.1k, 48k, 88.2k, 90k, 96k,
+ * 176.4k and 192k are an integer number of ticks.
+ * So are the 80 subframes of 23.976, 24, 25, 29.97, 30, 48, 50, 59.94
+ * and 60 fps.
+ * The range of int64_t corresponds to more than 200 years.
+ */
+#define TIMECODE_TICKS_PER_SECOND 1411200000
+
+/**
+ * rounding mode for rational rescaling
+ */
+typedef enum {
+	TIMECODE_ROUND_NEAREST = 0, ///< round to nearest, halfway cases away from zero
+	TIMECODE_ROUND_DOWN,        ///< round towards negative infinity
+	TIMECODE_ROUND_UP,          ///< round towards positive infinity
+	TIMECODE_ROUND_ZERO         ///< round towards zero
+} TimecodeRounding;
+
 /**
  * classical timecode
  */
@@ -266,6 +296,279 @@ void timecode_seconds_to_time (TimecodeTime * const t, TimecodeRate const * cons
 double timecode_to_sec (TimecodeTime const * const t, TimecodeRate const * const r);
 
 
+/* --- integer ticks --- */
+
+/**
+ * convert timecode to \ref TimecodeTicks.
+ *
+ * The result is exact if the duration of a subframe is an integer
+ * number of ticks, see \ref TIMECODE_TICKS_PER_SECOND.
+ * Otherwise it is rounded up, so that \ref timecode_ticks_to_time
+ * maps back to the same timecode.
+ *
+ * @param t the timecode to convert
+ * @param r frame rate
+ * @return ticks
+ */
+TimecodeTicks timecode_time_to_ticks (TimecodeTime const * const t, TimecodeRate const * const r);
+
+/**
+ * convert \ref TimecodeTicks to timecode, rounded down to the subframe.
+ *
+ * @param t [output] the timecode that corresponds to the ticks
+ * @param r frame rate
+ * @param ticks the ticks to convert
+ */
+void timecode_ticks_to_time (TimecodeTime * const t, TimecodeRate const * const r, const TimecodeTicks ticks);
+
+/**
+ * convert audio sample number to \ref TimecodeTicks.
+ * The conversion is exact for the sample rates listed at \ref TIMECODE_TICKS_PER_SECOND.
+ *
+ * @param sample the sample to convert
+ * @param samplerate the sample rate
+ * @return ticks
+ */
+TimecodeTicks timecode_sample_to_ticks (const int64_t sample, const int32_t samplerate);
+
+/**
+ * convert \ref TimecodeTicks to audio sample number, rounded down.
+ *
+ * @param ticks the ticks to convert
+ * @param samplerate the sample rate
+ * @return sample number
+ */
+int64_t timecode_ticks_to_sample (const TimecodeTicks ticks, const int32_t samplerate);
+
+/**
+ * convert video frame-number to \ref TimecodeTicks.
+ * The conversion is exact for the frame rates listed at \ref TIMECODE_TICKS_PER_SECOND.
+ *
+ * @param frameno the frame-number to convert
+ * @param r frame rate
+ * @return ticks
+ */
+TimecodeTicks timecode_framenumber_to_ticks (const int64_t frameno, TimecodeRate const * const r);
+
+/**
+ * convert \ref TimecodeTicks to video frame-number, rounded down.
+ *
+ * @param ticks the ticks to convert
+ * @param r frame rate
+ * @return frame-number
+ */
+int64_t timecode_ticks_to_framenumber (const TimecodeTicks ticks, TimecodeRate const * const r);
+
+
+/* --- absolute time: nanoseconds since the epoch --- */
+
+/**
+ * convert date and time to nanoseconds since 1970-01-01 00:00:00 UTC.
+ *
+ * The timecode is interpreted as the real time elapsed since local
+ * midnight of its date: frame-number * den / num seconds (see
+ * \ref timecode_to_framenumber). At fractional rates a timecode day is
+ * therefore not exactly 24 hours, e.g. 24:00:00:00 at 29.97 fps non-drop
+ * is 86486.4 seconds. The local time is converted to UTC by subtracting
+ * the timezone offset.
+ *
+ * The calculation is exact integer math. The result is the first
+ * nanosecond at or after the start of the subframe, which
+ * \ref timecode_epoch_ns_to_datetime maps back to the same timecode,
+ * unless the timecode is later than the next local midnight.
+ * This only happens at fractional non-drop-frame rates: the last 86.4
+ * seconds of labels (from about 23:58:33 on) overlap the next date and
+ * map back to 00:00:00:00 .. 00:01:26 of that date.
+ *
+ * If the timecode has no date (month == 0), 1970-01-01 is assumed.
+ *
+ * @param tc the date, time, timezone and rate to convert
+ * @return nanoseconds since the epoch
+ */
+int64_t timecode_datetime_to_epoch_ns (Timecode const * const tc);
+
+/**
+ * convert nanoseconds since 1970-01-01 00:00:00 UTC to date and time,
+ * rounded down to the subframe. This is the inverse of
+ * \ref timecode_datetime_to_epoch_ns.
+ *
+ * The date is always the local calendar date of \a ns, the time counts
+ * from its midnight.
+ * Drop-frame timecode has fewer labels than a 24 hour day has frames, the
+ * last frames of a day (less than 0.1 seconds) are represented with hour 24.
+ * Fractional non-drop-frame timecode has more labels than that; the labels
+ * after 24 hours are never returned, the next date is used instead.
+ *
+ * @param tc [output] date and time, the rate and timezone are set to \a r and \a timezone
+ * @param r frame rate
+ * @param timezone timezone offset in minutes, see \ref TimecodeDate
+ * @param ns nanoseconds since the epoch
+ */
+void timecode_epoch_ns_to_datetime (Timecode * const tc, TimecodeRate const * const r, const int32_t timezone, const int64_t ns);
+
+/**
+ * convert an array of timecodes to nanoseconds since the epoch,
+ * see \ref timecode_datetime_to_epoch_ns.
+ * The array is processed fastest if consecutive elements use the same rate.
+ *
+ * @param out [output] array of \a n nanosecond values
+ * @param in array of \a n timecodes
+ * @param n number of elements
+ */
+void timecode_datetime_to_epoch_ns_batch (int64_t * const out, Timecode const * const in, const size_t n);
+
+/**
+ * convert an array of nanosecond values to date and time,
+ * see \ref timecode_epoch_ns_to_datetime.
+ *
+ * @param out [output] array of \a n timecodes
+ * @param r frame rate
+ * @param timezone timezone offset in minutes
+ * @param in array of \a n nanosecond values
+ * @param n number of elements
+ */
+void timecode_epoch_ns_to_datetime_batch (Timecode * const out, TimecodeRate const * const r, const int32_t timezone, int64_t const * const in, const size_t n);
+
+
+/* --- container timestamps --- */
+
+/**
+ * convert timecode to a presentation timestamp in units of the rational
+ * time base tb_num/tb_den seconds, e.g. 1/90000 for MPEG-TS, 1/48000 for
+ * audio or 1001/30000 for a 29.97 fps video stream.
+ *
+ * The calculation is exact, using 128-bit intermediates where available.
+ * Timestamp 0 corresponds to 00:00:00:00.
+ *
+ * @param t the timecode to convert
+ * @param r frame rate of the timecode
+ * @param tb_num numerator of the time base, must be positive
+ * @param tb_den denominator of the time base, must be positive
+ * @param rnd rounding mode, used if the timecode falls between two timestamps
+ * @return timestamp in time base units
+ */
+int64_t timecode_time_to_pts (TimecodeTime const * const t, TimecodeRate const * const r, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd);
+
+/**
+ * convert a presentation timestamp in units of tb_num/tb_den seconds to timecode.
+ *
+ * @param t [output] timecode
+ * @param r frame rate of the timecode
+ * @param pts the timestamp to convert, must not be negative
+ * @param tb_num numerator of the time base, must be positive
+ * @param tb_den denominator of the time base, must be positive
+ * @param rnd rounding mode, used if the timestamp falls between two subframes
+ */
+void timecode_pts_to_time (TimecodeTime * const t, TimecodeRate const * const r, const int64_t pts, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd);
+
+/**
+ * convert an array of timecodes to presentation timestamps,
+ * see \ref timecode_time_to_pts.
+ *
+ * @param out [output] array of \a n timestamps
+ * @param in array of \a n timecodes
+ * @param n number of elements
+ * @param r frame rate of the timecodes
+ * @param tb_num numerator of the time base
+ * @param tb_den denominator of the time base
+ * @param rnd rounding mode
+ */
+void timecode_time_to_pts_batch (int64_t * const out, TimecodeTime const * const in, const size_t n, TimecodeRate const * const r, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd);
+
+/**
+ * convert an array of presentation timestamps to timecode,
+ * see \ref timecode_pts_to_time.
+ *
+ * @param out [output] array of \a n timecodes
+ * @param in array of \a n timestamps
+ * @param n number of elements
+ * @param r frame rate of the timecodes
+ * @param tb_num numerator of the time base
+ * @param tb_den denominator of the time base
+ * @param rnd rounding mode
+ */
+void timecode_pts_to_time_batch (TimecodeTime * const out, int64_t const * const in, const size_t n, TimecodeRate const * const r, const int32_t tb_num, const int32_t tb_den, const TimecodeRounding rnd);
+
+/* --- frame boundaries in an audio block --- */
+
+/**
+ * find the samples in the block [start, start + nframes) at which a new
+ * timecode frame begins, i.e. where the frame reported by
+ * \ref timecode_sample_to_time differs from the one of the previous sample.
+ * Sample 0 is always a boundary.
+ *
+ * The result is identical to calling \ref timecode_sample_to_time for every
+ * sample. Note that with subframes, a frame begins half a subframe early,
+ * where the subframe rounds up into the next frame.
+ *
+ * This function does not allocate memory and is real-time safe.
+ *
+ * @param r frame rate
+ * @param samplerate sample rate
+ * @param start first sample of the block
+ * @param nframes number of samples in the block
+ * @param offsets [output] array of \a max offsets relative to \a start, may be NULL
+ * @param tc [output] array of \a max timecodes at the boundaries, may be NULL
+ * @param max maximum number of boundaries to report
+ * @return number of boundaries that were found, at most \a max
+ */
+size_t timecode_frame_boundaries (TimecodeRate const * const r, const double samplerate, const int64_t start, const size_t nframes, size_t * const offsets, TimecodeTime * const tc, const size_t max);
+
+/* --- rational remapping (pull-up/pull-down, varispeed) --- */
+
+/**
+ * scale a sample position by the rational factor num/den
+ * e.g. 1000/1001 for a 24 -> 23.976 pull-down or 25/24 for a PAL speed-up.
+ *
+ * The result is computed with integer math and rounded to the nearest
+ * sample (halfway cases away from zero).
+ *
+ * If num >= den, remapping the result with den/num yields the original
+ * sample position.
+ *
+ * @param sample the sample position to remap
+ * @param num numerator of the scale factor, must be positive
+ * @param den denominator of the scale factor, must be positive
+ * @return remapped sample position
+ */
+int64_t timecode_remap_sample (const int64_t sample, const int32_t num, const int32_t den);
+
+/**
+ * scale an array of sample positions by the rational factor num/den,
+ * see \ref timecode_remap_sample.
+ *
+ * Note: out and in may point to the same array.
+ *
+ * @param out [output] array of \a n remapped sample positions
+ * @param in array of \a n sample positions
+ * @param n number of elements
+ * @param num numerator of the scale factor, must be positive
+ * @param den denominator of the scale factor, must be positive
+ */
+void timecode_remap_samples (int64_t * const out, int64_t const * const in, const size_t n, const int32_t num, const int32_t den);
+
+/**
+ * pull timecode: scale the real-time position of timecode t_in by
+ * num/den and express the result as timecode at frame rate r_out.
+ *
+ * e.g. a 24 fps timecode pulled down to 23.976 fps uses r_in = r_out = 24/1
+ * and num/den = 1001/1000: every frame now lasts 1001/1000 longer.
+ *
+ * The calculation is exact, using subframe units of both rates, and rounds
+ * to the nearest subframe of r_out.
+ *
+ * Note: if t_out points to the same timecode as t_in, the timecode will be modified.
+ *
+ * @param t_out [output] remapped timecode
+ * @param r_out frame rate of t_out
+ * @param t_in the timecode to remap
+ * @param r_in frame rate of t_in
+ * @param num numerator of the scale factor, must be positive
+ * @param den denominator of the scale factor, must be positive
+ */
+void timecode_remap_time (TimecodeTime * const t_out, TimecodeRate const * const r_out, TimecodeTime const * const t_in, TimecodeRate const * const r_in, const int32_t num, const int32_t den);
+
+
 /*  --- add/subtract timecodes at same frame rate  --- */
 
 /**
@@ -492,7 +795,16 @@ void timecode_parse_packed_time (TimecodeTime * const t, const char *val);
 void timecode_parse_timezone (TimecodeDate * const d, const char *val);
 
 /**
- * TODO documentation
+ * parse a frame-rate given as "num[/den][df|ndf]", e.g. "25", "30000/1001df".
+ *
+ * For the built-in rates \ref timecode_rate_lookup (timecode_rates.h) is
+ * faster, accepts more aliases and reports unknown names.
+ *
+ * @param r [in,out] the parsed frame-rate
+ * @param val the value to parse
+ * @param flags bitwise or of 1: set drop-frame for 29.97 fps unless "df" or "ndf" is given,
+ * 2: keep r->drop unless "df" or "ndf" is given, 4: keep r->subframes,
+ * 8: ignore "df" and "ndf" suffixes
  */
 void timecode_parse_framerate (TimecodeRate * const r, const char *val, int flags);
 
@@ -541,7 +853,6 @@ void timecode_move_date_overflow(TimecodeDate * const d);
 
 /* TODO, ideas */
 // add compare function that ignores subframes (or any field) via flag
-// Bar, Beat, Tick Time (Tempo-Based Time)
 
 #ifdef __cplusplus
 }
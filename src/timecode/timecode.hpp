@@ -0,0 +1,295 @@
+/**
+   @brief libtimecode - C++17 compile-time frame-rate wrapper
+   @file timecode.hpp
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_HPP
+#define TIMECODE_HPP 1
+
+#if __cplusplus < 201703L
+#error "timecode.hpp requires C++17"
+#endif
+
+#include <cstdint>
+#include <chrono>
+#include <ratio>
+#include "timecode.h"
+
+/**
+ * C++ value types with the frame-rate and sample-rate as template
+ * parameters. All conversions and arithmetic are constexpr integer math,
+ * with the rate known at compile-time the compiler folds all constants:
+ * @code
+ * namespace tc = timecode;
+ * constexpr tc::Timecode<tc::FPS25> t (10, 0, 0, 0);
+ * constexpr tc::SamplePos<48000> pos = t.to_sample<48000> ();
+ * static_assert (pos.value == 1728000000);
+ * @endcode
+ *
+ * Conversions use exact rational arithmetic with the same rounding as
+ * the C functions (\ref timecode_to_sample, \ref timecode_sample_to_time).
+ * Exact ties (half a subframe or half a sample) are rounded to even,
+ * where the C result depends on floating-point precision.
+ *
+ * Timecode<> stores a plain \ref TimecodeTime, conversion from and to the
+ * C API is a copy.
+ *
+ * Note: timecode::Timecode<> and the C struct ::Timecode share a name,
+ * prefer a namespace alias over "using namespace timecode".
+ */
+namespace timecode {
+
+namespace detail {
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 wide_t;
+#else
+typedef int64_t wide_t;
+#endif
+
+/* floor (x / d), d > 0 */
+constexpr int64_t div_floor (wide_t x, wide_t d) {
+	wide_t q = x / d;
+	if ((x % d) < 0) --q;
+	return (int64_t) q;
+}
+
+/* x / d rounded to nearest, ties to even (like rint()), d > 0 */
+constexpr int64_t div_rint (wide_t x, wide_t d) {
+	wide_t q = x / d;
+	wide_t r = x % d;
+	if (r < 0) { r += d; --q; }
+	if (2 * r > d || (2 * r == d && (q & 1))) ++q;
+	return (int64_t) q;
+}
+}
+
+/**
+ * compile-time frame-rate
+ * @tparam Num fps numerator
+ * @tparam Den fps denominator
+ * @tparam Drop use drop-frame timecode (only valid for 30000/1001 and 30/1)
+ * @tparam Subframes number of subframes per frame - may be zero
+ */
+template <int32_t Num, int32_t Den = 1, bool Drop = false, int32_t Subframes = 80>
+struct Rate {
+	static_assert (Num > 0 && Den > 0, "invalid frame-rate");
+	static_assert (Subframes >= 0, "invalid number of subframes");
+	static_assert (!Drop || (Num + Den - 1) / Den == 30, "drop-frame is only defined for 30 fps");
+
+	static constexpr int32_t num = Num;
+	static constexpr int32_t den = Den;
+	static constexpr bool drop = Drop;
+	static constexpr int32_t subframes = Subframes;
+	/** integer frames per second, ceil(num/den) */
+	static constexpr int64_t fps = (Num + Den - 1) / Den;
+
+	/** the corresponding C rate */
+	static constexpr TimecodeRate c_rate () { return TimecodeRate { Num, Den, Drop, Subframes }; }
+};
+
+typedef Rate<24000, 1001>       FPS23976;
+typedef Rate<   24>             FPS24;
+typedef Rate<25000, 1001>       FPS24976;
+typedef Rate<   25>             FPS25;
+typedef Rate<30000, 1001>       FPS2997NDF;
+typedef Rate<30000, 1001, true> FPS2997DF;
+typedef Rate<   30>             FPS30;
+typedef Rate<   30,    1, true> FPS30DF;
+typedef Rate<60000, 1001>       FPS5994;
+typedef Rate<   60>             FPS60;
+
+/**
+ * audio sample position at a compile-time sample-rate
+ */
+template <int32_t SampleRate>
+struct SamplePos {
+	static_assert (SampleRate > 0, "invalid sample-rate");
+	static constexpr int32_t samplerate = SampleRate;
+	typedef std::chrono::duration<int64_t, std::ratio<1, SampleRate> > duration;
+
+	int64_t value;
+
+	constexpr SamplePos () : value (0) {}
+	constexpr explicit SamplePos (int64_t s) : value (s) {}
+
+	/** the position as std::chrono::duration since 00:00:00:00 */
+	constexpr duration to_duration () const { return duration (value); }
+
+	/** convert a std::chrono::duration, rounded down to the previous sample */
+	template <class Rep, class Period>
+	static constexpr SamplePos from_duration (std::chrono::duration<Rep, Period> const& d) {
+		return SamplePos (std::chrono::floor<duration> (d).count ());
+	}
+
+	constexpr SamplePos operator+ (SamplePos const& o) const { return SamplePos (value + o.value); }
+	constexpr SamplePos operator- (SamplePos const& o) const { return SamplePos (value - o.value); }
+	constexpr bool operator== (SamplePos const& o) const { return value == o.value; }
+	constexpr bool operator!= (SamplePos const& o) const { return value != o.value; }
+	constexpr bool operator<  (SamplePos const& o) const { return value <  o.value; }
+	constexpr bool operator<= (SamplePos const& o) const { return value <= o.value; }
+	constexpr bool operator>  (SamplePos const& o) const { return value >  o.value; }
+	constexpr bool operator>= (SamplePos const& o) const { return value >= o.value; }
+};
+
+/**
+ * timecode at a compile-time frame-rate
+ */
+template <class R>
+class Timecode {
+public:
+	typedef R rate;
+	/** duration of one subframe (or frame if the rate has no subframes) */
+	typedef std::chrono::duration<int64_t, std::ratio<R::den, (intmax_t) R::num * (R::subframes > 0 ? R::subframes : 1)> > duration;
+
+	constexpr Timecode () : _t { 0, 0, 0, 0, 0 } {}
+	constexpr explicit Timecode (TimecodeTime const& t) : _t (t) {}
+	constexpr Timecode (int32_t h, int32_t m, int32_t s, int32_t f, int32_t sf = 0) : _t { h, m, s, f, sf } {}
+
+	/** the C timecode */
+	constexpr TimecodeTime const& c_time () const { return _t; }
+	/** the C frame-rate */
+	static constexpr TimecodeRate c_rate () { return R::c_rate (); }
+
+	constexpr int32_t hour () const { return _t.hour; }
+	constexpr int32_t minute () const { return _t.minute; }
+	constexpr int32_t second () const { return _t.second; }
+	constexpr int32_t frame () const { return _t.frame; }
+	constexpr int32_t subframe () const { return _t.subframe; }
+
+	/** frame number, subframes are ignored. Same as \ref timecode_to_framenumber for subframe 0 */
+	constexpr int64_t frames () const {
+		int64_t f = R::fps * (3600 * (int64_t)_t.hour + 60 * _t.minute + _t.second) + _t.frame;
+		if (R::drop) {
+			const int64_t total_minutes = 60 * (int64_t)_t.hour + _t.minute;
+			f -= 2 * (total_minutes - total_minutes / 10);
+		}
+		return f;
+	}
+
+	/** number of subframes since 00:00:00:00 */
+	constexpr int64_t subframe_count () const {
+		return R::subframes > 0 ? frames () * R::subframes + _t.subframe : frames ();
+	}
+
+	/** timecode of a frame number, same as \ref timecode_framenumber_to_time */
+	static constexpr Timecode from_frames (int64_t f, int32_t sf = 0) {
+		if (R::drop) {
+			const int64_t f10 = 600 * R::fps - 18;
+			const int64_t f1  =  60 * R::fps - 2;
+			const int64_t D = f / f10;
+			const int64_t M = f % f10;
+			f += 18 * D + 2 * ((M - 2) / f1);
+		}
+		return Timecode (
+				(int32_t) (f / R::fps / 3600),
+				(int32_t) (f / R::fps / 60 % 60),
+				(int32_t) (f / R::fps % 60),
+				(int32_t) (f % R::fps),
+				sf);
+	}
+
+	/** inverse of \ref subframe_count */
+	static constexpr Timecode from_subframe_count (int64_t n) {
+		if (R::subframes > 0) {
+			return from_frames (detail::div_floor (n, R::subframes), (int32_t) (n - R::subframes * detail::div_floor (n, R::subframes)));
+		}
+		return from_frames (n);
+	}
+
+	/** convert to audio-sample, same as \ref timecode_to_sample */
+	template <int32_t SR>
+	constexpr SamplePos<SR> to_sample () const {
+		const detail::wide_t fden = R::num;
+		const detail::wide_t fnum = (detail::wide_t) SR * R::den;
+		const detail::wide_t fn = (detail::wide_t) frames () * fnum;
+		int64_t s = R::drop ? detail::div_floor (fn, fden) : detail::div_rint (fn, fden);
+		if (R::subframes > 0) {
+			s += detail::div_rint ((detail::wide_t) _t.subframe * fnum, fden * R::subframes);
+		}
+		return SamplePos<SR> (s);
+	}
+
+	/** convert from audio-sample, same as \ref timecode_sample_to_time */
+	template <int32_t SR>
+	static constexpr Timecode from_sample (SamplePos<SR> const& s) {
+		const detail::wide_t n = (detail::wide_t) s.value * R::num;
+		const detail::wide_t d = (detail::wide_t) SR * R::den;
+		if (R::subframes > 0) {
+			return from_subframe_count (detail::div_rint (n * R::subframes, d));
+		}
+		return from_frames (detail::div_floor (n, d));
+	}
+
+	/** time since 00:00:00:00 */
+	constexpr duration to_duration () const { return duration (subframe_count ()); }
+
+	/** convert a std::chrono::duration, rounded down to the previous subframe */
+	template <class Rep, class Period>
+	static constexpr Timecode from_duration (std::chrono::duration<Rep, Period> const& d) {
+		return from_subframe_count (std::chrono::floor<duration> (d).count ());
+	}
+
+	/** add, same as \ref timecode_time_add for valid timecodes */
+	constexpr Timecode operator+ (Timecode const& o) const { return from_subframe_count (subframe_count () + o.subframe_count ()); }
+	/** subtract, the result must not be negative */
+	constexpr Timecode operator- (Timecode const& o) const { return from_subframe_count (subframe_count () - o.subframe_count ()); }
+	constexpr Timecode& operator+= (Timecode const& o) { return *this = *this + o; }
+	constexpr Timecode& operator-= (Timecode const& o) { return *this = *this - o; }
+
+	/** advance by one frame, wraps at 24:00:00:00 like \ref timecode_time_increment */
+	constexpr Timecode& operator++ () {
+		*this = from_frames ((frames () + 1) % day_frames (), _t.subframe);
+		return *this;
+	}
+	/** go back by one frame, wraps at 00:00:00:00 like \ref timecode_time_decrement */
+	constexpr Timecode& operator-- () {
+		*this = from_frames ((frames () + day_frames () - 1) % day_frames (), _t.subframe);
+		return *this;
+	}
+
+	constexpr bool operator== (Timecode const& o) const { return subframe_count () == o.subframe_count (); }
+	constexpr bool operator!= (Timecode const& o) const { return subframe_count () != o.subframe_count (); }
+	constexpr bool operator<  (Timecode const& o) const { return subframe_count () <  o.subframe_count (); }
+	constexpr bool operator<= (Timecode const& o) const { return subframe_count () <= o.subframe_count (); }
+	constexpr bool operator>  (Timecode const& o) const { return subframe_count () >  o.subframe_count (); }
+	constexpr bool operator>= (Timecode const& o) const { return subframe_count () >= o.subframe_count (); }
+
+	/** number of frames in 24 hours */
+	static constexpr int64_t day_frames () {
+		return R::drop ? 24 * 6 * (600 * R::fps - 18) : 24 * 3600 * R::fps;
+	}
+
+private:
+	TimecodeTime _t;
+};
+
+/**
+ * convert between frame-rates, via the exact rational time of the subframe
+ * (rounded down), unlike \ref timecode_convert_rate which rounds via samples.
+ */
+template <class Rout, class Rin>
+constexpr Timecode<Rout> convert_rate (Timecode<Rin> const& t) {
+	return Timecode<Rout>::from_duration (t.to_duration ());
+}
+
+}
+
+#endif
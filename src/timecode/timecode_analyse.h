@@ -0,0 +1,120 @@
+/**
+   @brief libtimecode - discontinuity and dropout detection
+   @file timecode_analyse.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_ANALYSE_H
+#define TIMECODE_ANALYSE_H 1
+
+#include <stdint.h>
+#include <stddef.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_analyse.h
+ *
+ * Analyse a sequence of recorded timecodes, one per frame, e.g. decoded
+ * LTC or timecode read from video metadata. The sequence is split into
+ * continuous runs, and every discontinuity is classified.
+ *
+ * Timecodes are converted to frame numbers, and the difference of adjacent
+ * frame numbers is checked in blocks. Blocks without discontinuity
+ * are processed in a tight loop that the compiler can vectorize, a full day
+ * of frames takes a few milliseconds.
+ * Wrapping around at midnight is not a discontinuity.
+ */
+
+/**
+ * classification of a discontinuity
+ */
+typedef enum {
+	TIMECODE_ANOMALY_REPEAT = 0, ///< the timecode did not advance
+	TIMECODE_ANOMALY_DROP,       ///< a few frames are missing, up to \a max_drop
+	TIMECODE_ANOMALY_JUMP,       ///< the timecode jumped forward more than \a max_drop frames, or backwards
+	TIMECODE_ANOMALY_DROPFRAME,  ///< frames 0 and 1 were skipped at a minute boundary where they should not, or vice versa
+	TIMECODE_ANOMALY_INVALID,    ///< the timecode is out of range or a label that does not exist in drop-frame
+	TIMECODE_ANOMALY_COUNT
+} TimecodeAnomalyType;
+
+/**
+ * a continuous run of timecodes
+ */
+typedef struct TimecodeRun {
+	size_t start;   ///< index of the first timecode in the input
+	size_t length;  ///< number of timecodes
+	int64_t frame;  ///< frame number of the first timecode
+} TimecodeRun;
+
+/**
+ * a discontinuity between two adjacent timecodes
+ */
+typedef struct TimecodeAnomaly {
+	size_t index;             ///< index of the timecode after the discontinuity
+	TimecodeAnomalyType type; ///< classification
+	int64_t delta;            ///< offset from the expected frame number, e.g. -1 for a repeat, 0 for invalid timecodes
+} TimecodeAnomaly;
+
+/**
+ * result of \ref timecode_analyse
+ */
+typedef struct TimecodeAnalysis {
+	size_t n_runs;            ///< number of runs
+	TimecodeRun *runs;        ///< continuous runs, in input order
+	size_t n_anomalies;       ///< number of anomalies
+	TimecodeAnomaly *anomalies; ///< discontinuities, in input order
+	size_t count[TIMECODE_ANOMALY_COUNT]; ///< number of anomalies per type
+} TimecodeAnalysis;
+
+/**
+ * analyse a sequence of timecodes.
+ *
+ * @param t array of timecodes, one per frame, subframes are ignored
+ * @param n number of timecodes
+ * @param r frame-rate of the timecodes
+ * @param max_drop forward jumps of up to this many missing frames are
+ * classified as \ref TIMECODE_ANOMALY_DROP, larger ones as
+ * \ref TIMECODE_ANOMALY_JUMP. If zero, one second is used.
+ * @return analysis, free with \ref timecode_analysis_free, or NULL if out of memory
+ */
+TimecodeAnalysis *timecode_analyse (TimecodeTime const * const t, const size_t n, TimecodeRate const * const r, int64_t max_drop);
+
+/**
+ * free the result of \ref timecode_analyse
+ * @param a the analysis to free
+ */
+void timecode_analysis_free (TimecodeAnalysis *a);
+
+/**
+ * name of an anomaly type, e.g. "repeat"
+ * @param type anomaly type
+ * @return static string, NULL if the type is invalid
+ */
+const char *timecode_anomaly_name (const TimecodeAnomalyType type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,180 @@
+/**
+   @brief libtimecode - compact binary timecode streams
+   @file timecode_bin.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_BIN_H
+#define TIMECODE_BIN_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_bin.h
+ *
+ * A stream starts with a header:
+ *  - 4 bytes magic "TCB1"
+ *  - 1 byte rate ID (see timecode_rates.h), if 0 it is followed by an
+ *    explicit rate: num (int32), den (int32), drop (uint8), subframes (int32)
+ *  - the date anchor: year (int16), month (uint8), day (uint8), timezone (int16)
+ *
+ * All integers are little-endian. Every timecode is represented as count
+ * of subframes since midnight of the anchor date, and encoded relative to
+ * the expected value: the previous timecode advanced by one frame.
+ *  - 0x00..0x7f: a run of 1..128 timecodes, each one frame after the previous
+ *  - 0x80..0xbf: one timecode, -32..+31 subframes off the expected value
+ *  - 0xc0 followed by a zig-zag LEB128 varint: one timecode at an arbitrary offset
+ *
+ * A continuous stream needs one byte per 128 timecodes.
+ *
+ * Readers and writers operate directly on caller supplied memory, they do
+ * not allocate and are real-time safe.
+ */
+
+/** maximum size of the stream header in bytes */
+#define TIMECODE_BIN_HEADER_MAX 24
+
+/** maximum size of one encoded timecode in bytes */
+#define TIMECODE_BIN_ENTRY_MAX 11
+
+/**
+ * binary stream writer state, treat as opaque
+ */
+typedef struct TimecodeBinWriter {
+	uint8_t *buf;     ///< output buffer
+	size_t size;      ///< size of buf in bytes
+	size_t pos;       ///< bytes written to buf
+	size_t run;       ///< position of the open run token in buf + 1, 0: none
+	int64_t expected; ///< next expected subframe count
+	int64_t anchor;   ///< anchor date, days since 1970-01-01
+	TimecodeRate r;   ///< rate of the stream
+} TimecodeBinWriter;
+
+/**
+ * binary stream reader state, treat as opaque
+ */
+typedef struct TimecodeBinReader {
+	const uint8_t *buf; ///< input buffer
+	size_t size;        ///< size of buf in bytes
+	size_t pos;         ///< bytes consumed
+	int32_t run;        ///< remaining timecodes of the current run
+	int64_t expected;   ///< next expected subframe count
+	int64_t anchor;     ///< anchor date, days since 1970-01-01
+	TimecodeRate r;     ///< rate of the stream
+	TimecodeDate d;     ///< anchor date and timezone
+} TimecodeBinReader;
+
+/**
+ * start a new stream and write the header.
+ *
+ * @param w writer to initialize
+ * @param buf output buffer
+ * @param size size of buf in bytes, at least \ref TIMECODE_BIN_HEADER_MAX
+ * @param anchor rate and date of the stream, the time is not used
+ * @return 0 on success, -1 if the buffer is too small
+ */
+int timecode_bin_writer_init (TimecodeBinWriter * const w, uint8_t * const buf, const size_t size, Timecode const * const anchor);
+
+/**
+ * continue the stream in a new buffer, e.g. after the previous buffer was
+ * written to disk. The new data is to be appended to the previous data.
+ *
+ * @param w the writer
+ * @param buf output buffer
+ * @param size size of buf in bytes
+ */
+void timecode_bin_writer_set_buffer (TimecodeBinWriter * const w, uint8_t * const buf, const size_t size);
+
+/**
+ * query the number of bytes written to the current buffer
+ * @param w the writer
+ * @return number of bytes
+ */
+size_t timecode_bin_writer_length (TimecodeBinWriter const * const w);
+
+/**
+ * append a timecode to the stream.
+ * The rate of the timecode must be the same as the rate of the stream,
+ * the date is relative to the anchor date, the timezone is ignored.
+ * If the anchor has no date (month == 0), the date of the timecode is
+ * ignored as well and timecodes are read back modulo 24 hours.
+ *
+ * @param w the writer
+ * @param tc the timecode to append
+ * @return 0 on success, -1 if the buffer is full or the rate does not match (nothing is written)
+ */
+int timecode_bin_write (TimecodeBinWriter * const w, Timecode const * const tc);
+
+/**
+ * append an array of timecodes to the stream.
+ * @param w the writer
+ * @param tc array of timecodes
+ * @param n number of timecodes
+ * @return number of timecodes that were written, less than \a n if the buffer is full
+ */
+size_t timecode_bin_write_batch (TimecodeBinWriter * const w, Timecode const * const tc, const size_t n);
+
+/**
+ * parse the stream header.
+ *
+ * @param rd reader to initialize
+ * @param buf input buffer, starting with a stream header
+ * @param size size of buf in bytes
+ * @return 0 on success, -1 if the header is invalid or incomplete
+ */
+int timecode_bin_reader_init (TimecodeBinReader * const rd, const uint8_t * const buf, const size_t size);
+
+/**
+ * continue reading in a new buffer.
+ * Tokens must not be split between buffers, this is guaranteed for
+ * buffers filled by \ref timecode_bin_writer_set_buffer.
+ * @param rd the reader
+ * @param buf input buffer
+ * @param size size of buf in bytes
+ */
+void timecode_bin_reader_set_buffer (TimecodeBinReader * const rd, const uint8_t * const buf, const size_t size);
+
+/**
+ * read the next timecode.
+ * @param rd the reader
+ * @param tc [output] timecode, with the stream rate, date and timezone
+ * @return 1 if a timecode was read, 0 at the end of the buffer, -1 on error
+ */
+int timecode_bin_read (TimecodeBinReader * const rd, Timecode * const tc);
+
+/**
+ * read up to \a n timecodes.
+ * @param rd the reader
+ * @param tc [output] array of timecodes
+ * @param n size of the array
+ * @return number of timecodes that were read
+ */
+size_t timecode_bin_read_batch (TimecodeBinReader * const rd, Timecode * const tc, const size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+/**
+   @brief libtimecode - memoizing sample to timecode converter
+   @file timecode_cursor.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_CURSOR_H
+#define TIMECODE_CURSOR_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_cursor.h
+ *
+ * A cursor converts sample positions to timecode like
+ * \ref timecode_sample_to_time, and remembers the last result.
+ * This is useful when the queried positions are mostly monotonic and
+ * close to each other, e.g. a UI clock or per-block automation.
+ *
+ * A query is resolved at the cheapest of three levels:
+ *  - hit: the sample is within the range of samples that is already known
+ *    to produce the cached timecode. This is a compare only.
+ *  - near: the sample is in the same or in the next frame. The frame and
+ *    subframe are computed, but the timecode is updated from the cached
+ *    one instead of being decomposed into hours, minutes, seconds and frames.
+ *  - miss: anything else, the full conversion is used.
+ *
+ * The results are identical to \ref timecode_sample_to_time.
+ * A cursor must not be used by more than one thread at a time.
+ * It does not allocate memory and is real-time safe.
+ */
+
+/**
+ * cursor state.
+ *
+ * The structure is allocated by the caller. The counters may be read
+ * and reset directly, all other fields are private.
+ */
+typedef struct TimecodeCursor {
+	TimecodeRate r;     ///< frame rate
+	double samplerate;  ///< sample rate
+	double fps_d;       ///< frames per second
+	double spf;         ///< samples per frame
+	int64_t fps_i;      ///< integer frames per second
+	int64_t fph;        ///< samples per hour, non-drop-frame only
+	int valid;          ///< 1 if the cached timecode is valid
+	int64_t lo;         ///< first sample known to produce t
+	int64_t hi;         ///< last sample known to produce t
+	int64_t base;       ///< non-drop-frame: first sample of the hour of t
+	int64_t frame;      ///< frame index of t, as computed by the conversion
+	TimecodeTime t;     ///< cached timecode
+	uint64_t hits;      ///< queries answered from the cached range
+	uint64_t near;      ///< queries answered from the same or next frame
+	uint64_t misses;    ///< queries that used the full conversion
+} TimecodeCursor;
+
+/**
+ * initialize a cursor, and reset its counters.
+ *
+ * @param c the cursor to initialize
+ * @param r frame rate
+ * @param samplerate sample rate
+ */
+void timecode_cursor_init (TimecodeCursor * const c, TimecodeRate const * const r, const double samplerate);
+
+/**
+ * convert a sample position to timecode, see \ref timecode_sample_to_time.
+ *
+ * @param c the cursor
+ * @param t [output] timecode
+ * @param sample the sample to convert
+ */
+void timecode_cursor_sample_to_time (TimecodeCursor * const c, TimecodeTime * const t, const int64_t sample);
+
+/**
+ * query the share of queries that did not need the full conversion.
+ *
+ * @param c the cursor
+ * @return (hits + near) / (hits + near + misses), 0 if there were no queries
+ */
+double timecode_cursor_hit_rate (TimecodeCursor const * const c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,130 @@
+/**
+   @brief libtimecode - CMX3600 edit decision lists
+   @file timecode_edl.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_EDL_H
+#define TIMECODE_EDL_H 1
+
+#include <stdint.h>
+#include <stddef.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_edl.h
+ *
+ * CMX3600 EDL reader and writer.
+ *
+ * Events are stored as a table of parallel arrays, one entry per event.
+ * Timecodes are resolved to frame numbers at the rate of the list: the
+ * frame-rate given to the parser, with drop-frame as selected by the
+ * preceding "FCM:" line. Comments, motion effects and other notes are
+ * not retained.
+ *
+ * @code
+ * TimecodeEdl *edl = timecode_edl_load("conform.edl", timecode_FPS2997DF);
+ * for (i = 0; i < edl->count; ++i) {
+ *   duration += edl->rec_out[i] - edl->rec_in[i];
+ * }
+ * timecode_edl_free(edl);
+ * @endcode
+ */
+
+/** maximum length of a reel name, including the terminating zero */
+#define TIMECODE_EDL_REEL_MAX 33
+
+/** maximum length of a track (channel) name, including the terminating zero */
+#define TIMECODE_EDL_TRACK_MAX 8
+
+/**
+ * event table, all arrays have \a count elements.
+ * Allocated by the parser, free with \ref timecode_edl_free.
+ */
+typedef struct TimecodeEdl {
+	char title[80];     ///< from the "TITLE:" line
+	TimecodeRate rate;  ///< frame-rate of the list, drop-frame as of the first event
+	size_t count;       ///< number of events
+	size_t skipped;     ///< number of malformed event lines that were ignored
+	int32_t *event;     ///< event number
+	char (*reel)[TIMECODE_EDL_REEL_MAX];   ///< source reel name
+	char (*track)[TIMECODE_EDL_TRACK_MAX]; ///< track, e.g. "V", "A", "A2", "B"
+	char *transition;   ///< transition type, 'C'ut, 'D'issolve, 'W'ipe, 'K'ey
+	int32_t *duration;  ///< transition duration in frames, 0 for cuts
+	uint8_t *drop;      ///< 1 if the event's timecodes are drop-frame (FCM)
+	int64_t *src_in;    ///< source in, frame number
+	int64_t *src_out;   ///< source out, frame number
+	int64_t *rec_in;    ///< record in, frame number
+	int64_t *rec_out;   ///< record out, frame number
+	size_t alloc;       ///< allocated number of elements, private
+} TimecodeEdl;
+
+/**
+ * parse an EDL from memory.
+ * @param text the EDL, does not need to be zero-terminated
+ * @param len length of text in bytes
+ * @param r frame-rate of the timecodes, the drop-frame flag is set by "FCM:" lines
+ * @return event table or NULL on error (out of memory)
+ */
+TimecodeEdl *timecode_edl_parse (const char *text, const size_t len, TimecodeRate const * const r);
+
+/**
+ * map a file and parse it, see \ref timecode_edl_parse
+ * @param path file to read
+ * @param r frame-rate of the timecodes
+ * @return event table or NULL on error
+ */
+TimecodeEdl *timecode_edl_load (const char *path, TimecodeRate const * const r);
+
+/**
+ * free an event table
+ * @param edl the table to free
+ */
+void timecode_edl_free (TimecodeEdl *edl);
+
+/**
+ * format an event table as CMX3600 EDL.
+ * Like snprintf(), the output is truncated to \a size bytes and always
+ * zero-terminated if size > 0.
+ *
+ * @param edl the event table
+ * @param buf output buffer, may be NULL if size is 0
+ * @param size size of buf in bytes
+ * @return length of the complete EDL excluding the terminating zero
+ */
+size_t timecode_edl_format (TimecodeEdl const * const edl, char *buf, const size_t size);
+
+/**
+ * write an event table to a file, see \ref timecode_edl_format
+ * @param edl the event table
+ * @param path file to write
+ * @return 0 on success, -1 on error
+ */
+int timecode_edl_save (TimecodeEdl const * const edl, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,149 @@
+/**
+   @brief libtimecode - memory-mapped frame index
+   @file timecode_index.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_INDEX_H
+#define TIMECODE_INDEX_H 1
+
+#include <stdint.h>
+#include <stddef.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_index.h
+ *
+ * An index maps the frame numbers of a recording to timecode and back.
+ * Only continuous runs are stored: a new run starts whenever the timecode
+ * does not advance by one frame, e.g. when the recording was stopped and
+ * restarted.
+ *
+ * File layout, all sections start at a multiple of
+ * \ref TIMECODE_INDEX_PAGE_SIZE bytes:
+ *  - header page
+ *  - array of \ref TimecodeIndexRun, sorted by frame number
+ *  - array of run indices sorted by timecode, with the end of each run and
+ *    the latest end of all runs up to it
+ *
+ * The file is in host byte order, and is used in-place via mmap() without
+ * parsing. Opening an index takes constant time, lookups in either
+ * direction are O(log n) in the number of runs, plus the number of
+ * earlier runs that overlap the timecode.
+ */
+
+/** alignment of the sections of an index file */
+#define TIMECODE_INDEX_PAGE_SIZE 4096
+
+/**
+ * a continuous run of frames
+ */
+typedef struct TimecodeIndexRun {
+	int64_t frame;      ///< frame number of the first frame in the recording
+	int64_t length;     ///< number of frames in the run
+	TimecodeTicks key;  ///< sort key, set by \ref timecode_index_write
+	Timecode tc;        ///< timecode of the first frame, the subframe is ignored
+	int32_t reserved;   ///< padding, set to zero
+} TimecodeIndexRun;
+
+/**
+ * opaque index handle
+ */
+typedef struct TimecodeIndex TimecodeIndex;
+
+/**
+ * write an index file.
+ *
+ * The runs do not need to be sorted, but must not overlap in frame numbers.
+ * If a date is given (month > 0), a run can cross midnight. Without date
+ * the timecode wraps around at 24:00:00:00.
+ *
+ * @param path file to write
+ * @param runs array of runs
+ * @param n number of runs
+ * @return 0 on success, -1 on error (overlapping or empty runs, I/O error)
+ */
+int timecode_index_write (const char *path, TimecodeIndexRun const * const runs, const size_t n);
+
+/**
+ * open an index file for lookups.
+ *
+ * The header and all runs are validated once, a truncated, corrupt or
+ * incompatible file is rejected.
+ *
+ * @param path the file to open
+ * @return index handle or NULL on error, free with \ref timecode_index_close
+ */
+TimecodeIndex *timecode_index_open (const char *path);
+
+/**
+ * close an index file and free all resources.
+ * @param idx the index to close
+ */
+void timecode_index_close (TimecodeIndex *idx);
+
+/**
+ * query the number of runs
+ * @param idx the index
+ * @return number of runs
+ */
+size_t timecode_index_count (TimecodeIndex const * const idx);
+
+/**
+ * direct access to the runs, sorted by frame number
+ * @param idx the index
+ * @return pointer to an array of \ref timecode_index_count elements, valid until the index is closed
+ */
+TimecodeIndexRun const *timecode_index_runs (TimecodeIndex const * const idx);
+
+/**
+ * look up the timecode of a given frame
+ * @param idx the index
+ * @param frame frame number in the recording
+ * @param tc [output] timecode, with rate and date of the run
+ * @return 0 on success, -1 if the frame is not part of any run
+ */
+int timecode_index_frame_to_timecode (TimecodeIndex const * const idx, const int64_t frame, Timecode * const tc);
+
+/**
+ * look up the frame number of a given timecode.
+ * If several runs contain the timecode, the run with the latest start
+ * at or before the timecode is used. The rate of the timecode must match
+ * the rate of the run, the subframe is ignored.
+ * Runs without date are matched by time of day; a run that is longer
+ * than a day contains each timecode more than once, the first occurrence
+ * is used.
+ *
+ * @param idx the index
+ * @param tc timecode to look up, if the index has dates, the date must be set
+ * @param frame [output] frame number in the recording
+ * @return 0 on success, -1 if the timecode is not part of any run
+ */
+int timecode_index_timecode_to_frame (TimecodeIndex const * const idx, Timecode const * const tc, int64_t * const frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
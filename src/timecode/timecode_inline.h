@@ -0,0 +1,291 @@
+/**
+   @brief libtimecode - inline core conversion functions
+   @file timecode_inline.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_INLINE_H
+#define TIMECODE_INLINE_H 1
+
+#include <stdint.h>
+#include <math.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_inline.h
+ *
+ * static inline variants of the core conversion, increment and compare
+ * functions. These allow the compiler to inline the call and to fold
+ * constants when the frame-rate and sample-rate are known at compile-time:
+ * @code
+ * static const TimecodeRate fps25 = {25, 1, 0, 80};
+ * for (s = 0; s < n; ++s) {
+ *   timecode_inline_sample_to_time(&t[s], &fps25, 48000, start + s);
+ * }
+ * @endcode
+ *
+ * The shared library uses the very same code, results are identical to the
+ * corresponding exported function, e.g. \ref timecode_inline_to_sample and
+ * \ref timecode_to_sample.
+ */
+
+#ifndef TIMECODE_INLINE_SLOWPATH
+/* hook for library-internal instrumentation, see timecode_stats.h */
+#define TIMECODE_INLINE_SLOWPATH(id)
+#endif
+
+/**
+ * inline version of \ref timecode_to_sample
+ * @param t the timecode to convert
+ * @param r frame-rate of the timecode
+ * @param samplerate sample-rate
+ * @return sample number
+ */
+static inline int64_t timecode_inline_to_sample (TimecodeTime const * const t, TimecodeRate const * const r, const double samplerate) {
+	const double  fps_d = (double)r->num / (double)r->den;
+	const int64_t fps_i = ceil(fps_d);
+	const double frames_per_timecode_frame = samplerate / fps_d;
+	int64_t sample;
+
+	if (r->drop) {
+		TIMECODE_INLINE_SLOWPATH(DROPFRAME);
+		int64_t totalMinutes = 60 * t->hour + t->minute;
+		int64_t frameNumber  = fps_i * 3600 * t->hour + fps_i * 60 * t->minute
+			                 + fps_i * t->second + t->frame
+					 - 2 * (totalMinutes - totalMinutes / 10);
+
+		sample = floor (frameNumber * (samplerate / fps_d));
+	} else {
+		sample = (int64_t) rint(
+				(
+				   ((t->hour * 60 * 60) + (t->minute * 60) + t->second)
+				 * (fps_i * frames_per_timecode_frame)
+				)
+				 + (t->frame * frames_per_timecode_frame));
+	}
+	if (r->subframes != 0) {
+		sample += rint((double)t->subframe * frames_per_timecode_frame / (double)r->subframes);
+	}
+	return sample;
+}
+
+/**
+ * inline version of \ref timecode_sample_to_time
+ * @param t [output] timecode
+ * @param r frame-rate of the timecode
+ * @param samplerate sample-rate
+ * @param sample the sample to convert
+ */
+static inline void timecode_inline_sample_to_time (TimecodeTime * const t, TimecodeRate const * const r, const double samplerate, const int64_t sample) {
+	const double  fps_d = (double)r->num / (double)r->den;
+	const int64_t fps_i = ceil(fps_d);
+
+	if (r->drop) {
+		TIMECODE_INLINE_SLOWPATH(DROPFRAME);
+		int64_t frameNumber = floor( (double)sample * fps_d / samplerate );
+
+		t->subframe =  rint(r->subframes * ((double)sample * fps_d / samplerate - (double)frameNumber));
+
+		if (t->subframe == r->subframes && r->subframes != 0) {
+			TIMECODE_INLINE_SLOWPATH(SUBFRAME_CARRY);
+			t->subframe = 0;
+			frameNumber++;
+		}
+
+		/* there are 17982 frames in 10 min @ 29.97df */
+		const int64_t D = frameNumber / 17982;
+		const int64_t M = frameNumber % 17982;
+
+		frameNumber +=  18*D + 2*((M - 2) / 1798);
+
+		t->frame  =    frameNumber % 30;
+		t->second =   (frameNumber / 30) % 60;
+		t->minute =  ((frameNumber / 30) / 60) % 60;
+		t->hour   = (((frameNumber / 30) / 60) / 60);
+
+	} else {
+		double timecode_frames_left_exact;
+		double timecode_frames_fraction;
+		int64_t timecode_frames_left;
+		const double frames_per_timecode_frame = samplerate / fps_d;
+		const int64_t frames_per_hour = (int64_t)rint(3600 * fps_i * frames_per_timecode_frame);
+
+		t->hour = sample / frames_per_hour;
+		double sample_d = sample % frames_per_hour;
+
+		timecode_frames_left_exact = sample_d / frames_per_timecode_frame;
+		timecode_frames_fraction = timecode_frames_left_exact - floor( timecode_frames_left_exact );
+
+		t->subframe = (int32_t) rint(timecode_frames_fraction * r->subframes);
+
+		timecode_frames_left = (int64_t) floor (timecode_frames_left_exact);
+
+		if (t->subframe == r->subframes && r->subframes != 0) {
+			TIMECODE_INLINE_SLOWPATH(SUBFRAME_CARRY);
+			t->subframe = 0;
+			timecode_frames_left++;
+			if (timecode_frames_left >= fps_i * 3600) {
+				/* carry into the next hour, not to minute 60 */
+				timecode_frames_left -= fps_i * 3600;
+				t->hour++;
+			}
+		}
+
+		t->minute = timecode_frames_left / (fps_i * 60);
+		timecode_frames_left = timecode_frames_left % (fps_i * 60);
+		t->second = timecode_frames_left / fps_i;
+		t->frame  = timecode_frames_left % fps_i;
+	}
+}
+
+/**
+ * inline version of \ref timecode_to_framenumber
+ * @param t the timecode to convert
+ * @param r frame-rate of the timecode
+ * @return frame number
+ */
+static inline int64_t timecode_inline_to_framenumber (TimecodeTime const * const t, TimecodeRate const * const r) {
+	return timecode_inline_to_sample(t, r, (double)r->num / (double)r->den);
+}
+
+/**
+ * inline version of \ref timecode_framenumber_to_time
+ * @param t [output] timecode
+ * @param r frame-rate of the timecode
+ * @param frameno the frame number to convert
+ */
+static inline void timecode_inline_framenumber_to_time (TimecodeTime * const t, TimecodeRate const * const r, const int64_t frameno) {
+	timecode_inline_sample_to_time(t, r, (double)r->num / (double)r->den, frameno);
+}
+
+/**
+ * inline version of \ref timecode_convert_rate
+ * @param t_out [output] timecode
+ * @param r_out frame-rate of the output timecode
+ * @param t_in the timecode to convert
+ * @param r_in frame-rate of the input timecode
+ */
+static inline void timecode_inline_convert_rate (TimecodeTime * const t_out, TimecodeRate const * const r_out, TimecodeTime const * const t_in, TimecodeRate const * const r_in) {
+	const double fps_out = (double)r_out->num / (double)r_out->den;
+	const double fps_in = (double)r_in->num / (double)r_in->den;
+	const double rate = fps_out < fps_in ? fps_in : fps_out;
+	timecode_inline_sample_to_time(t_out, r_out, rate, timecode_inline_to_sample(t_in, r_in, rate));
+}
+
+/**
+ * inline version of \ref timecode_time_compare
+ * @param r frame-rate, unused
+ * @param a first timecode
+ * @param b second timecode
+ * @return +1 if a is later than b, -1 if a is earlier than b, 0 if timecodes are equal
+ */
+static inline int timecode_inline_time_compare (TimecodeRate const * const r, TimecodeTime const * const a, TimecodeTime const * const b) {
+	(void) r;
+	if (a->hour     != b->hour    ) return a->hour     > b->hour     ? 1 : -1;
+	if (a->minute   != b->minute  ) return a->minute   > b->minute   ? 1 : -1;
+	if (a->second   != b->second  ) return a->second   > b->second   ? 1 : -1;
+	if (a->frame    != b->frame   ) return a->frame    > b->frame    ? 1 : -1;
+	if (a->subframe != b->subframe) return a->subframe > b->subframe ? 1 : -1;
+	return (0);
+}
+
+/**
+ * inline version of \ref timecode_time_increment
+ * @param t the timecode to modify
+ * @param r frame-rate to use
+ * @return 1 if timecode wrapped around at 24:00:00:00, 0 otherwise
+ */
+static inline int timecode_inline_time_increment (TimecodeTime * const t, TimecodeRate const * const r) {
+	int rv = 0;
+	const int fps = ceil((double)r->num / (double)r->den);
+	t->frame++;
+
+	if (t->frame < fps) goto done;
+	t->frame = 0;
+	t->second++;
+	if (t->second < 60) goto done;
+	t->second = 0;
+	t->minute++;
+	if (t->minute < 60) goto done;
+	t->minute = 0;
+	t->hour++;
+	if (t->hour < 24) goto done;
+	t->hour = 0;
+	rv=1;
+	TIMECODE_INLINE_SLOWPATH(DAY_WRAP);
+
+done:
+	if (r->drop && (t->minute%10 != 0) && (t->second == 0) && (t->frame == 0)) {
+		TIMECODE_INLINE_SLOWPATH(DROPFRAME);
+		t->frame += 2;
+	}
+	return rv;
+}
+
+/**
+ * inline version of \ref timecode_time_decrement
+ * @param t the timecode to modify
+ * @param r frame-rate to use
+ * @return 1 if timecode wrapped around at 00:00:00:00, 0 otherwise
+ */
+static inline int timecode_inline_time_decrement (TimecodeTime * const t, TimecodeRate const * const r) {
+	const int fps = ceil((double)r->num / (double)r->den);
+
+	if (r->drop && (t->minute%10 != 0) && (t->second == 0) && (t->frame == 2)) {
+		TIMECODE_INLINE_SLOWPATH(DROPFRAME); // assume t->frame==0;
+	} else
+
+	if (t->frame > 0) {
+		t->frame--;
+		return 0;
+	}
+
+	t->frame = fps-1;
+	if (t->second > 0) {
+		t->second--;
+		return 0;
+	}
+
+	t->second = 59;
+	if (t->minute > 0) {
+		t->minute--;
+		return 0;
+	}
+
+	t->minute = 59;
+	if (t->hour > 0) {
+		t->hour--;
+		return 0;
+	}
+	t->hour = 23;
+	TIMECODE_INLINE_SLOWPATH(DAY_WRAP);
+
+	return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
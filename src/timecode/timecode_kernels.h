@@ -0,0 +1,83 @@
+/**
+   @brief libtimecode - per frame-rate specialized conversion kernels
+   @file timecode_kernels.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_KERNELS_H
+#define TIMECODE_KERNELS_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * table of conversion functions for one frame-rate.
+ *
+ * The function signatures are the same as the corresponding generic
+ * functions. Specialized kernels are compiled for a constant frame-rate:
+ * the drop-frame branch and the integer frame-rate are resolved at
+ * compile-time. They ignore the rate argument, the rate used to look up
+ * the table is implied.
+ *
+ * Results are identical to the generic functions.
+ */
+typedef struct TimecodeKernels {
+	TimecodeRate const *rate; ///< the rate the kernels are specialized for, NULL for the generic fallback
+	const char *name; ///< short description, e.g. "25" or "29.97df"
+	int64_t (*to_sample) (TimecodeTime const * const t, TimecodeRate const * const r, const double samplerate); ///< \ref timecode_to_sample
+	void (*sample_to_time) (TimecodeTime * const t, TimecodeRate const * const r, const double samplerate, const int64_t sample); ///< \ref timecode_sample_to_time
+	int64_t (*to_framenumber) (TimecodeTime const * const t, TimecodeRate const * const r); ///< \ref timecode_to_framenumber
+	void (*framenumber_to_time) (TimecodeTime * const t, TimecodeRate const * const r, const int64_t frameno); ///< \ref timecode_framenumber_to_time
+	int (*time_increment) (TimecodeTime * const t, TimecodeRate const * const r); ///< \ref timecode_time_increment
+	int (*time_decrement) (TimecodeTime * const t, TimecodeRate const * const r); ///< \ref timecode_time_decrement
+	void (*time_to_string) (char *smptestring, TimecodeTime const * const t); ///< \ref timecode_time_to_string
+} TimecodeKernels;
+
+/**
+ * look up the kernels for a given frame-rate.
+ *
+ * All built-in rates (24, 25, 30, 60 fps, their 1000/1001 variants,
+ * drop-frame, and the decimal rates 10, 100, 1000, 10^6, 10^9 fps) have
+ * specialized kernels. The rate must match including the number of
+ * subframes. Other rates get a table of the generic functions.
+ *
+ * The lookup is a short linear search, call it once per stream or
+ * rate-change, not per conversion:
+ * @code
+ * TimecodeKernels const * const k = timecode_rate_kernels(&tc.r);
+ * for (i = 0; i < n; ++i) {
+ *   k->sample_to_time(&t[i], &tc.r, 48000, start + i);
+ * }
+ * @endcode
+ *
+ * @param r frame-rate
+ * @return kernel table, never NULL. The table is static and must not be freed.
+ */
+TimecodeKernels const *timecode_rate_kernels (TimecodeRate const * const r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+/**
+   @brief libtimecode - LTC audio encoder
+   @file timecode_ltc.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_LTC_H
+#define TIMECODE_LTC_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * opaque LTC encoder instance
+ */
+typedef struct TimecodeLTCEncoder TimecodeLTCEncoder;
+
+/**
+ * allocate a new linear timecode (SMPTE 12M LTC) audio encoder.
+ *
+ * The encoder renders biphase-mark modulated LTC frames, starting
+ * with timecode \a start at sample zero. Every frame is advanced using
+ * \ref timecode_time_increment.
+ *
+ * The position of every bit-edge is derived from the absolute frame
+ * count using integer math, so fractional (1001) frame rates do not
+ * accumulate drift regardless of the block size used for rendering.
+ *
+ * @param r frame rate to encode, the nominal rate must be 30 fps or less
+ * @param samplerate the sample rate of the generated audio
+ * @param start timecode of the first frame
+ * @return encoder instance or NULL if the rate or sample rate is not supported
+ */
+TimecodeLTCEncoder *timecode_ltc_encoder_create (TimecodeRate const * const r, const int32_t samplerate, TimecodeTime const * const start);
+
+/**
+ * release an LTC encoder instance
+ * @param e the encoder to free
+ */
+void timecode_ltc_encoder_free (TimecodeLTCEncoder *e);
+
+/**
+ * relocate the encoder: the next sample rendered will be the start
+ * of a frame with timecode \a t.
+ *
+ * @param e the encoder instance
+ * @param t timecode of the next frame
+ */
+void timecode_ltc_encoder_reset (TimecodeLTCEncoder *e, TimecodeTime const * const t);
+
+/**
+ * set the output level.
+ * @param e the encoder instance
+ * @param amplitude peak amplitude 0..1 (default 0.5, -6dBFS)
+ */
+void timecode_ltc_encoder_set_volume (TimecodeLTCEncoder *e, const float amplitude);
+
+/**
+ * set the user-bits for all following frames.
+ * @param e the encoder instance
+ * @param userbits 8 user-bit nibbles, the least significant nibble is sent first
+ */
+void timecode_ltc_encoder_set_userbits (TimecodeLTCEncoder *e, const uint32_t userbits);
+
+/**
+ * query the timecode of the frame that is currently being rendered.
+ * @param e the encoder instance
+ * @param t [output] current timecode
+ */
+void timecode_ltc_encoder_get_time (TimecodeLTCEncoder const *e, TimecodeTime * const t);
+
+/**
+ * render LTC audio as floating point samples.
+ *
+ * All channels share a single bit-schedule and receive identical data.
+ *
+ * @param e the encoder instance
+ * @param bufs array of \a nchannels output buffers
+ * @param nchannels number of buffers in \a bufs
+ * @param nsamples number of samples to write to each buffer
+ */
+void timecode_ltc_encoder_render_float (TimecodeLTCEncoder *e, float * const * bufs, const unsigned int nchannels, const size_t nsamples);
+
+/**
+ * render LTC audio as signed 16 bit integer samples.
+ *
+ * see \ref timecode_ltc_encoder_render_float
+ *
+ * @param e the encoder instance
+ * @param bufs array of \a nchannels output buffers
+ * @param nchannels number of buffers in \a bufs
+ * @param nsamples number of samples to write to each buffer
+ */
+void timecode_ltc_encoder_render_int16 (TimecodeLTCEncoder *e, int16_t * const * bufs, const unsigned int nchannels, const size_t nsamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
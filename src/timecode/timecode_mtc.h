@@ -0,0 +1,149 @@
+/**
+   @brief libtimecode - MIDI Time Code
+   @file timecode_mtc.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_MTC_H
+#define TIMECODE_MTC_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * a MIDI message scheduled inside an audio block
+ */
+typedef struct TimecodeMTCMessage {
+	uint32_t offset; ///< sample offset relative to the start of the block
+	uint32_t size;   ///< number of valid bytes in data: 2 (quarter frame) or 10 (full frame)
+	uint8_t data[10]; ///< raw MIDI bytes
+} TimecodeMTCMessage;
+
+/**
+ * MTC generator state.
+ *
+ * The structure is allocated by the caller and all fields are private.
+ * None of the encoder functions allocate memory, lock or block, so they
+ * can be called directly from a realtime process callback.
+ */
+typedef struct TimecodeMTCEncoder {
+	TimecodeRate r;    ///< frame rate
+	int32_t samplerate; ///< audio sample rate
+	int type;          ///< MTC rate-code 0..3
+	TimecodeTime t;    ///< timecode of the frame at the current quarter-frame
+	TimecodeTime seq;  ///< timecode that is sent by the current quarter-frame sequence
+	int64_t qf;        ///< quarter-frames since last locate
+	int64_t next;      ///< sample position of quarter frame qf, relative to the last locate
+	int64_t pos;       ///< sample position of the next block, relative to the last locate
+	int full;          ///< send a full-frame message at the start of the next block
+} TimecodeMTCEncoder;
+
+/**
+ * MTC parser state.
+ *
+ * The structure is allocated by the caller and all fields are private,
+ * see \ref TimecodeMTCEncoder.
+ */
+typedef struct TimecodeMTCDecoder {
+	uint8_t sysex[10]; ///< full-frame SysEx buffer
+	int sysex_len;     ///< number of bytes in sysex, -1: not in a SysEx message
+	int qf_status;     ///< 1: the last byte was a quarter-frame status byte
+	uint8_t piece[8];  ///< quarter-frame nibbles
+	int pieces;        ///< number of consecutive quarter-frames received
+	int last;          ///< last quarter-frame piece number, -1 if none
+	int direction;     ///< 1: forward, -1: reverse, 0: unknown or stopped
+	Timecode tc;       ///< most recently decoded timecode
+} TimecodeMTCDecoder;
+
+/**
+ * initialize an MTC encoder.
+ *
+ * MTC supports 24, 25, 29.97df and 30 fps. 29.97 non-drop is sent as 30 fps.
+ *
+ * @param e the encoder state to initialize
+ * @param r frame rate
+ * @param samplerate the sample rate used to schedule messages
+ * @param start timecode of the first frame
+ * @return 0 on success, -1 if the frame rate is not supported by MTC
+ */
+int timecode_mtc_encoder_init (TimecodeMTCEncoder * const e, TimecodeRate const * const r, const int32_t samplerate, TimecodeTime const * const start);
+
+/**
+ * relocate the encoder. A full-frame message is sent at the
+ * start of the next block, followed by a new quarter-frame sequence.
+ *
+ * @param e the encoder state
+ * @param t new timecode
+ */
+void timecode_mtc_encoder_locate (TimecodeMTCEncoder * const e, TimecodeTime const * const t);
+
+/**
+ * generate MTC messages for the next \a nsamples samples.
+ *
+ * Quarter-frame message \a n after the last locate is scheduled at
+ * sample floor (n * samplerate / (4 * fps)), computed with integer math.
+ *
+ * @param e the encoder state
+ * @param nsamples number of samples in the block
+ * @param msg [output] array of messages
+ * @param max size of \a msg. Messages in excess of \a max are skipped.
+ * @return number of messages written to \a msg
+ */
+size_t timecode_mtc_encoder_process (TimecodeMTCEncoder * const e, const uint32_t nsamples, TimecodeMTCMessage * const msg, const size_t max);
+
+/**
+ * initialize an MTC decoder
+ * @param d the decoder state to initialize
+ */
+void timecode_mtc_decoder_init (TimecodeMTCDecoder * const d);
+
+/**
+ * parse MIDI bytes. Quarter-frame (0xF1) messages and full-frame SysEx messages
+ * are decoded, all other messages are ignored. A quarter-frame that does not
+ * continue the current sequence in either direction restarts the sequence.
+ *
+ * A complete quarter-frame sequence describes the time at which it started,
+ * the decoded timecode is compensated by two frames: incremented when
+ * running forward, decremented in reverse.
+ *
+ * @param d the decoder state
+ * @param buf MIDI data
+ * @param len number of bytes in \a buf
+ * @param tc [output] decoded timecode, only modified if the return value is non-zero (may be NULL)
+ * @return 1 if a new timecode was decoded, 0 otherwise
+ */
+int timecode_mtc_decoder_parse (TimecodeMTCDecoder * const d, const uint8_t *buf, const size_t len, Timecode * const tc);
+
+/**
+ * query the playback direction detected from the quarter-frame sequence.
+ * @param d the decoder state
+ * @return 1: forward, -1: reverse, 0: unknown or stopped
+ */
+int timecode_mtc_decoder_direction (TimecodeMTCDecoder const * const d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
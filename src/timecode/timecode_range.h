@@ -0,0 +1,86 @@
+/**
+   @brief libtimecode - generate consecutive timecodes
+   @file timecode_range.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_RANGE_H
+#define TIMECODE_RANGE_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_range.h
+ *
+ * Generate the timecode of every frame in a range of frame-numbers, e.g.
+ * for burn-in or caption files. The result is identical to calling
+ * \ref timecode_framenumber_to_time for every frame, including drop-frame
+ * labels, but only the first frame of each chunk is converted; the others
+ * are written a second at a time.
+ *
+ * Long ranges can be split over several threads. Each thread writes a
+ * contiguous part of the output, the order is not affected.
+ */
+
+/** size of one formatted timecode: "HH:MM:SS:FF" and a separator */
+#define TIMECODE_RANGE_STRIDE 12
+
+/**
+ * fill an array with the timecodes of consecutive frames.
+ * Like \ref timecode_framenumber_to_time, hours are not wrapped at 24.
+ * The subframe is zero.
+ *
+ * @param out [output] array of \a n timecodes
+ * @param r frame rate
+ * @param first frame-number of the first timecode, must not be negative
+ * @param n number of timecodes
+ * @param n_threads maximum number of threads to use, 0 or 1: only the calling thread
+ * @return 0 on success, -1 if the range is invalid
+ */
+int timecode_range_fill (TimecodeTime * const out, TimecodeRate const * const r, const int64_t first, const size_t n, const int n_threads);
+
+/**
+ * write formatted timecodes "HH:MM:SS:FF" of consecutive frames.
+ * Every timecode is followed by the separator, e.g. '\\n' for a text
+ * file or '\\0' for an array of C strings. The output is not terminated.
+ *
+ * The output for frame-number \a first + i starts at
+ * out + i * \ref TIMECODE_RANGE_STRIDE.
+ *
+ * @param out [output] buffer of at least \a n * \ref TIMECODE_RANGE_STRIDE bytes
+ * @param r frame rate, at most 100 fps
+ * @param first frame-number of the first timecode, must not be negative
+ * @param n number of timecodes
+ * @param separator character to write after every timecode
+ * @param n_threads maximum number of threads to use, 0 or 1: only the calling thread
+ * @return 0 on success, -1 if the range is invalid or reaches 100 hours
+ */
+int timecode_range_format (char * const out, TimecodeRate const * const r, const int64_t first, const size_t n, const char separator, const int n_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+/**
+   @brief libtimecode - frame-rate registry
+   @file timecode_rates.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_RATES_H
+#define TIMECODE_RATES_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * stable IDs of the built-in frame-rates.
+ *
+ * The values are part of the API and will not change, they can be stored
+ * in files or records (they fit into a byte) instead of a \ref TimecodeRate.
+ */
+typedef enum TimecodeRateID {
+	TIMECODE_RATE_INVALID = 0, ///< unknown rate
+	TIMECODE_RATE_23976   = 1, ///< 24000/1001, 80 subframes
+	TIMECODE_RATE_24      = 2, ///< 24, 80 subframes
+	TIMECODE_RATE_24976   = 3, ///< 25000/1001, 80 subframes
+	TIMECODE_RATE_25      = 4, ///< 25, 80 subframes
+	TIMECODE_RATE_2997NDF = 5, ///< 30000/1001 non-drop, 80 subframes
+	TIMECODE_RATE_2997DF  = 6, ///< 30000/1001 drop-frame, 80 subframes
+	TIMECODE_RATE_30      = 7, ///< 30, 80 subframes
+	TIMECODE_RATE_30DF    = 8, ///< 30 drop-frame, 80 subframes
+	TIMECODE_RATE_5994    = 9, ///< 60000/1001, 80 subframes
+	TIMECODE_RATE_60      = 10, ///< 60, 80 subframes
+	TIMECODE_RATE_DS      = 11, ///< 10, 1000 subframes (deci-seconds)
+	TIMECODE_RATE_CS      = 12, ///< 100, 1000 subframes (centi-seconds)
+	TIMECODE_RATE_MS      = 13, ///< 1000, 1000 subframes (milli-seconds)
+	TIMECODE_RATE_US      = 14, ///< 10^6, no subframes (micro-seconds)
+	TIMECODE_RATE_NS      = 15, ///< 10^9, no subframes (nano-seconds)
+	TIMECODE_RATE_COUNT          ///< one more than the largest ID
+} TimecodeRateID;
+
+/**
+ * look up a frame-rate by name.
+ *
+ * Accepted names are the canonical name (see \ref timecode_rate_name) and
+ * aliases, case-insensitive, e.g. "29.97df", "2997df", "30000/1001df",
+ * "ntsc" or "30000/1001", "2997", "29.97ndf" for non-drop, "pal" for 25fps
+ * and "ds", "cs", "ms", "us", "ns" for decimal time.
+ *
+ * The lookup uses a perfect hash and a single string compare.
+ *
+ * @param name the name to look up, zero terminated
+ * @return rate ID or TIMECODE_RATE_INVALID if the name is not known
+ */
+TimecodeRateID timecode_rate_lookup (const char *name);
+
+/**
+ * like \ref timecode_rate_lookup for a string that is not zero terminated.
+ * @param name the name to look up
+ * @param len length of name in bytes
+ * @return rate ID or TIMECODE_RATE_INVALID if the name is not known
+ */
+TimecodeRateID timecode_rate_lookup_n (const char *name, const size_t len);
+
+/**
+ * look up an array of names.
+ * @param ids [output] array of \a n rate IDs, TIMECODE_RATE_INVALID for unknown names
+ * @param names array of \a n zero terminated names
+ * @param n number of names
+ * @return number of names that were found
+ */
+size_t timecode_rate_lookup_bulk (TimecodeRateID * const ids, const char * const * const names, const size_t n);
+
+/**
+ * query the frame-rate of an ID.
+ *
+ * The returned pointer is the same as the corresponding public constant,
+ * e.g. timecode_rate_by_id(TIMECODE_RATE_25) == timecode_FPS25.
+ *
+ * @param id rate ID
+ * @return frame-rate or NULL if the ID is not valid
+ */
+TimecodeRate const *timecode_rate_by_id (const TimecodeRateID id);
+
+/**
+ * find the ID of a frame-rate, all fields including the number of
+ * subframes must match.
+ * @param r frame-rate
+ * @return rate ID or TIMECODE_RATE_INVALID for non-standard rates
+ */
+TimecodeRateID timecode_rate_id (TimecodeRate const * const r);
+
+/**
+ * query the canonical name of a rate ID, e.g. "29.97df".
+ * @param id rate ID
+ * @return name or NULL if the ID is not valid
+ */
+const char *timecode_rate_name (const TimecodeRateID id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/**
+   @brief libtimecode - hot-path instrumentation counters
+   @file timecode_stats.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_STATS_H
+#define TIMECODE_STATS_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * counter IDs.
+ *
+ * Function call counters include calls made by the library itself,
+ * e.g. \ref timecode_to_framenumber is counted as \ref timecode_to_sample call.
+ */
+typedef enum TimecodeStatsCounter {
+	TIMECODE_STAT_TO_SAMPLE = 0,   ///< timecode_to_sample() calls
+	TIMECODE_STAT_SAMPLE_TO_TIME,  ///< timecode_sample_to_time() calls
+	TIMECODE_STAT_CONVERT_RATE,    ///< timecode_convert_rate() calls
+	TIMECODE_STAT_TIME_ADD,        ///< timecode_time_add() calls
+	TIMECODE_STAT_TIME_SUBTRACT,   ///< timecode_time_subtract() calls
+	TIMECODE_STAT_TIME_COMPARE,    ///< timecode_time_compare() calls
+	TIMECODE_STAT_TIME_INCREMENT,  ///< timecode_time_increment() calls
+	TIMECODE_STAT_TIME_DECREMENT,  ///< timecode_time_decrement() calls
+	TIMECODE_STAT_PARSE_TIME,      ///< timecode_parse_time() calls
+	TIMECODE_STAT_DROPFRAME,       ///< slow-path: drop-frame computation
+	TIMECODE_STAT_SUBFRAME_CARRY,  ///< slow-path: subframe rounded up to the next frame
+	TIMECODE_STAT_OVERFLOW,        ///< slow-path: a field was out of range and was normalized
+	TIMECODE_STAT_DAY_WRAP,        ///< slow-path: increment or decrement wrapped around midnight
+	TIMECODE_STAT_COUNT            ///< number of counters
+} TimecodeStatsCounter;
+
+/**
+ * aggregated counters
+ */
+typedef struct TimecodeStats {
+	uint64_t count[TIMECODE_STAT_COUNT];  ///< number of calls or slow-path hits
+	uint64_t cycles[TIMECODE_STAT_COUNT]; ///< accumulated CPU cycles (function calls only), zero unless timing is enabled
+	int timing; ///< 1 if CPU cycles are measured
+} TimecodeStats;
+
+/**
+ * collect the counters of all threads.
+ *
+ * Counters are only available if the library was configured with
+ * --enable-instrumentation, optionally --enable-instrumentation=timing
+ * to also measure CPU cycles using the time stamp counter (x86 only).
+ * Otherwise the library contains no instrumentation code at all.
+ *
+ * Each thread counts in its own thread-local block, which is merged into
+ * the global totals when the thread exits. A snapshot reads the blocks of
+ * running threads while they count, counters of a thread that is
+ * busy calling into the library may be a few calls behind.
+ * A thread that cannot allocate its block is not counted.
+ *
+ * @param s [output] aggregated counters, zeroed if instrumentation is not available
+ * @return 0 on success, -1 if the library was compiled without instrumentation
+ */
+int timecode_stats_snapshot (TimecodeStats * const s);
+
+/**
+ * reset the counters of all threads to zero.
+ *
+ * This is safe while other threads are counting, but a counter that a
+ * running thread updates at the same time may keep its previous value.
+ * Reset while the library is idle for exact counts.
+ */
+void timecode_stats_reset (void);
+
+/**
+ * query the name of a counter
+ * @param c counter ID
+ * @return name, e.g. "timecode_to_sample" or "dropframe", or NULL for invalid IDs
+ */
+const char *timecode_stats_name (const int c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
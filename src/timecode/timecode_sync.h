@@ -0,0 +1,144 @@
+/**
+   @brief libtimecode - timecode jitter and drift statistics
+   @file timecode_sync.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_SYNC_H
+#define TIMECODE_SYNC_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_sync.h
+ *
+ * Streaming statistics of received timecode against the local sample clock.
+ *
+ * For every received timecode, the offset is the arrival sample minus the
+ * expected position: origin + \ref timecode_to_sample. The statistics
+ * object keeps the count, mean, variance, minimum and maximum of the
+ * offset, a least-squares estimate of the drift (the slope of the offset
+ * over arrival time) and a histogram of the offsets.
+ *
+ * The histogram has a logarithmic scale with linear sub-buckets, similar
+ * to HdrHistogram: offsets up to 15 samples have their own bucket, larger
+ * ones are recorded with a relative precision of 1/8.
+ *
+ * \ref timecode_sync_update is O(1), does not allocate, lock or block, and
+ * can be called from a realtime thread. A single thread may update the
+ * statistics, any other thread can read them with \ref timecode_sync_snapshot.
+ */
+
+/** number of histogram buckets for each sign */
+#define TIMECODE_SYNC_HIST_BUCKETS 336
+
+/**
+ * statistics state.
+ *
+ * The structure is allocated by the caller and all fields are private.
+ */
+typedef struct TimecodeSyncStats {
+	uint32_t seq;        ///< sequence counter, odd while an update is in progress
+	double samplerate;   ///< sample rate of the local clock
+	int64_t origin;      ///< sample position of timecode 00:00:00:00
+	int64_t count;       ///< number of updates
+	int64_t min;         ///< smallest offset
+	int64_t max;         ///< largest offset
+	int64_t x0;          ///< arrival of the first update
+	double mean_x;       ///< running mean of the arrival, relative to x0
+	double mean_y;       ///< running mean of the offset
+	double m2_x;         ///< sum of squared arrival deviations
+	double m2_y;         ///< sum of squared offset deviations
+	double c_xy;         ///< co-moment of arrival and offset
+	uint32_t hist[2][TIMECODE_SYNC_HIST_BUCKETS]; ///< [0]: negative offsets, [1]: zero and positive offsets
+} TimecodeSyncStats;
+
+/**
+ * consistent copy of the statistics
+ */
+typedef struct TimecodeSyncSnapshot {
+	int64_t count;     ///< number of updates
+	double mean;       ///< mean offset in samples
+	double variance;   ///< variance of the offset in samples^2
+	int64_t min;       ///< smallest offset in samples
+	int64_t max;       ///< largest offset in samples
+	double drift;      ///< change of the offset per sample, e.g. 1e-6 = 1 ppm; positive: timecode is slower than the local clock
+	uint32_t hist[2][TIMECODE_SYNC_HIST_BUCKETS]; ///< offset histogram, see \ref timecode_sync_bucket_range
+} TimecodeSyncSnapshot;
+
+/**
+ * initialize or reset the statistics.
+ * This must not be called concurrently with \ref timecode_sync_update.
+ *
+ * @param s the statistics to initialize
+ * @param samplerate sample rate of the local clock
+ * @param origin sample position that corresponds to timecode 00:00:00:00
+ */
+void timecode_sync_init (TimecodeSyncStats * const s, const double samplerate, const int64_t origin);
+
+/**
+ * record a received timecode.
+ *
+ * @param s the statistics
+ * @param arrival sample position at which the timecode was received
+ * @param t the received timecode
+ * @param r frame-rate of the timecode
+ * @return offset: arrival - expected position, in samples
+ */
+int64_t timecode_sync_update (TimecodeSyncStats * const s, const int64_t arrival, TimecodeTime const * const t, TimecodeRate const * const r);
+
+/**
+ * read the statistics, this can be called from any thread.
+ *
+ * @param s the statistics
+ * @param snap [output] consistent copy of the statistics
+ * @return 0 on success, -1 if no consistent copy could be made because
+ * of concurrent updates. Try again later.
+ */
+int timecode_sync_snapshot (TimecodeSyncStats const * const s, TimecodeSyncSnapshot * const snap);
+
+/**
+ * query the range of offset magnitudes that is counted in a histogram bucket.
+ *
+ * @param bucket bucket index 0 .. \ref TIMECODE_SYNC_HIST_BUCKETS - 1
+ * @param lo [output] smallest magnitude in the bucket
+ * @param hi [output] largest magnitude in the bucket
+ */
+void timecode_sync_bucket_range (const int bucket, int64_t * const lo, int64_t * const hi);
+
+/**
+ * estimate a percentile of the offset from the histogram.
+ *
+ * @param snap the statistics
+ * @param p percentile, 0..100
+ * @return offset in samples, the end of the bucket that is furthest from zero
+ */
+int64_t timecode_sync_percentile (TimecodeSyncSnapshot const * const snap, const double p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,183 @@
+/**
+   @brief libtimecode - tempo map, Bar Beat Tick time
+   @file timecode_tempo.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_TEMPO_H
+#define TIMECODE_TEMPO_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** resolution of \ref TimecodeBBT ticks */
+#define TIMECODE_BBT_TICKS_PER_BEAT 1920
+
+/**
+ * musical time
+ */
+typedef struct TimecodeBBT {
+	int32_t bar;  ///< bar 1..
+	int32_t beat; ///< beat in bar 1..beats_per_bar
+	int32_t tick; ///< tick in beat 0..TIMECODE_BBT_TICKS_PER_BEAT-1
+} TimecodeBBT;
+
+/**
+ * opaque tempo map
+ */
+typedef struct TimecodeTempoMap TimecodeTempoMap;
+
+/**
+ * allocate a new tempo map with an initial tempo and meter at bar 1.
+ *
+ * Tempo and meter changes are stored in a flat array of segments along with
+ * the cumulative sample position at the start of each segment. All
+ * conversions locate the segment using a binary search, O(log n).
+ *
+ * @param samplerate sample rate used for sample positions
+ * @param bpm initial tempo in quarter-notes per minute
+ * @param beats_per_bar initial meter, numerator
+ * @param beat_type initial meter, note value of a beat (4: quarter note, 8: eighth note)
+ * @return tempo map or NULL on error
+ */
+TimecodeTempoMap *timecode_tempomap_create (const double samplerate, const double bpm, const int32_t beats_per_bar, const int32_t beat_type);
+
+/**
+ * release a tempo map
+ * @param m the tempo map to free
+ */
+void timecode_tempomap_free (TimecodeTempoMap *m);
+
+/**
+ * add a tempo change, an existing tempo change at the same position is replaced.
+ *
+ * @param m the tempo map
+ * @param pos position of the tempo change
+ * @param bpm tempo in quarter-notes per minute
+ * @return 0 on success, -1 on error
+ */
+int timecode_tempomap_add_tempo (TimecodeTempoMap *m, TimecodeBBT const * const pos, const double bpm);
+
+/**
+ * add a meter change at the start of a bar,
+ * an existing meter change at the same bar is replaced.
+ *
+ * @param m the tempo map
+ * @param bar the bar at which the meter changes
+ * @param beats_per_bar numerator
+ * @param beat_type note value of a beat
+ * @return 0 on success, -1 on error
+ */
+int timecode_tempomap_add_meter (TimecodeTempoMap *m, const int32_t bar, const int32_t beats_per_bar, const int32_t beat_type);
+
+/**
+ * query the number of segments (constant tempo and meter) in the map.
+ * @param m the tempo map
+ * @return number of segments
+ */
+size_t timecode_tempomap_segments (TimecodeTempoMap const * const m);
+
+/**
+ * convert musical time to floating point seconds.
+ * @param m the tempo map
+ * @param bbt the musical time to convert
+ * @return seconds
+ */
+double timecode_tempomap_bbt_to_seconds (TimecodeTempoMap const * const m, TimecodeBBT const * const bbt);
+
+/**
+ * convert floating point seconds to musical time, rounded to the nearest tick.
+ * @param m the tempo map
+ * @param bbt [output] musical time
+ * @param sec seconds to convert
+ */
+void timecode_tempomap_seconds_to_bbt (TimecodeTempoMap const * const m, TimecodeBBT * const bbt, const double sec);
+
+/**
+ * convert musical time to the nearest audio sample.
+ * @param m the tempo map
+ * @param bbt the musical time to convert
+ * @return sample number
+ */
+int64_t timecode_tempomap_bbt_to_sample (TimecodeTempoMap const * const m, TimecodeBBT const * const bbt);
+
+/**
+ * convert audio sample number to musical time, rounded to the nearest tick.
+ * @param m the tempo map
+ * @param bbt [output] musical time
+ * @param sample the sample to convert
+ */
+void timecode_tempomap_sample_to_bbt (TimecodeTempoMap const * const m, TimecodeBBT * const bbt, const int64_t sample);
+
+/**
+ * convert musical time to timecode.
+ * uses \ref timecode_tempomap_bbt_to_sample and \ref timecode_sample_to_time.
+ *
+ * @param m the tempo map
+ * @param t [output] timecode
+ * @param r frame rate of the timecode
+ * @param bbt the musical time to convert
+ */
+void timecode_tempomap_bbt_to_time (TimecodeTempoMap const * const m, TimecodeTime * const t, TimecodeRate const * const r, TimecodeBBT const * const bbt);
+
+/**
+ * convert timecode to musical time.
+ * uses \ref timecode_to_sample and \ref timecode_tempomap_sample_to_bbt.
+ *
+ * @param m the tempo map
+ * @param bbt [output] musical time
+ * @param t the timecode to convert
+ * @param r frame rate of the timecode
+ */
+void timecode_tempomap_time_to_bbt (TimecodeTempoMap const * const m, TimecodeBBT * const bbt, TimecodeTime const * const t, TimecodeRate const * const r);
+
+/**
+ * convert an array of musical times to sample numbers.
+ *
+ * The segment of the previous element is tried first, sorted input
+ * (e.g. a note list) is converted in amortized constant time per element.
+ *
+ * @param m the tempo map
+ * @param out [output] array of \a n sample numbers
+ * @param in array of \a n musical times
+ * @param n number of elements
+ */
+void timecode_tempomap_bbt_to_sample_batch (TimecodeTempoMap const * const m, int64_t * const out, TimecodeBBT const * const in, const size_t n);
+
+/**
+ * convert an array of sample numbers to musical time,
+ * see \ref timecode_tempomap_bbt_to_sample_batch.
+ *
+ * @param m the tempo map
+ * @param out [output] array of \a n musical times
+ * @param in array of \a n sample numbers
+ * @param n number of elements
+ */
+void timecode_tempomap_sample_to_bbt_batch (TimecodeTempoMap const * const m, TimecodeBBT * const out, int64_t const * const in, const size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,208 @@
+/**
+   @brief libtimecode - 64-bit timecode for high rates and long durations
+   @file timecode_time64.h
+   @author Robin Gareus <robin@gareus.org>
+
+   Copyright (C) 2006, 2007, 2008, 2012 Robin Gareus <robin@gareus.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU Lesser Public License as published by
+   the Free Software Foundation; either version 3, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU Lesser Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef TIMECODE_TIME64_H
+#define TIMECODE_TIME64_H 1
+
+#include <stdint.h>
+#include "timecode.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file timecode_time64.h
+ *
+ * \ref TimecodeTime64 is a timecode or duration with 64-bit fields and
+ * hours that do not wrap at 24. It is intended for high rates such as
+ * 1 MHz or 1 GHz "frames" and for durations of days or years.
+ *
+ * All conversions use integer math and are exact; intermediate products
+ * use 128-bit integers where the compiler supports them.
+ * The total number of subframes (frames * subframes-per-frame + subframe)
+ * must fit into an int64_t, e.g. more than 290 years at 1 GHz.
+ *
+ * Negative values are normalized like a floor division: the hour is
+ * negative and the other fields are positive, e.g. one frame before
+ * 00:00:00:00 at 25 fps is -1:59:59:24.
+ */
+
+/** size of a buffer that can hold any \ref timecode_time64_to_string result */
+#define TIMECODE_TIME64_STRING_SIZE 48
+
+/**
+ * wide timecode or duration
+ */
+typedef struct TimecodeTime64 {
+	int64_t hour;     ///< hours, unbounded
+	int64_t minute;   ///< minutes 0..59
+	int64_t second;   ///< seconds 0..59
+	int64_t frame;    ///< frames 0..fps-1
+	int64_t subframe; ///< subframes 0..subframes-1
+} TimecodeTime64;
+
+/**
+ * widen a timecode.
+ * @param t64 [output] wide timecode
+ * @param t the timecode to copy
+ */
+void timecode_time_to_time64 (TimecodeTime64 * const t64, TimecodeTime const * const t);
+
+/**
+ * narrow a wide timecode, the hour is wrapped to 0..23.
+ * @param t [output] timecode
+ * @param t64 the wide timecode
+ * @return number of days that were removed from the hours, negative for negative timecode
+ */
+int64_t timecode_time64_to_time (TimecodeTime * const t, TimecodeTime64 const * const t64);
+
+/**
+ * convert timecode to total number of subframes, frame-number * subframes + subframe.
+ * If the rate has no subframes, this is the frame-number.
+ * @param t the timecode to convert
+ * @param r frame rate
+ * @return subframe count
+ */
+int64_t timecode_time64_to_subframes (TimecodeTime64 const * const t, TimecodeRate const * const r);
+
+/**
+ * convert total number of subframes to timecode.
+ * @param t [output] timecode
+ * @param r frame rate
+ * @param subframes subframe count, see \ref timecode_time64_to_subframes
+ */
+void timecode_subframes_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const int64_t subframes);
+
+/**
+ * convert timecode to video frame-number, the subframe is ignored.
+ * For timecodes before 24:00:00:00 the result is identical to \ref timecode_to_framenumber.
+ * @param t the timecode to convert
+ * @param r frame rate
+ * @return frame-number
+ */
+int64_t timecode_time64_to_framenumber (TimecodeTime64 const * const t, TimecodeRate const * const r);
+
+/**
+ * convert video frame-number to timecode.
+ * @param t [output] timecode, the subframe is zero
+ * @param r frame rate
+ * @param frameno the frame-number to convert
+ */
+void timecode_framenumber_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const int64_t frameno);
+
+/**
+ * convert timecode to audio sample number, rounded to the nearest sample.
+ * @param t the timecode to convert
+ * @param r frame rate
+ * @param samplerate sample rate
+ * @return sample number
+ */
+int64_t timecode_time64_to_sample (TimecodeTime64 const * const t, TimecodeRate const * const r, const int32_t samplerate);
+
+/**
+ * convert audio sample number to timecode, rounded to the nearest subframe.
+ * @param t [output] timecode
+ * @param r frame rate
+ * @param samplerate sample rate
+ * @param sample the sample number to convert
+ */
+void timecode_sample_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const int32_t samplerate, const int64_t sample);
+
+/**
+ * convert timecode to \ref TimecodeTicks, rounded up if the subframe
+ * is not an integer number of ticks, see \ref timecode_time_to_ticks.
+ * @param t the timecode to convert
+ * @param r frame rate
+ * @return ticks
+ */
+TimecodeTicks timecode_time64_to_ticks (TimecodeTime64 const * const t, TimecodeRate const * const r);
+
+/**
+ * convert \ref TimecodeTicks to timecode, rounded down to the subframe.
+ * @param t [output] timecode
+ * @param r frame rate
+ * @param ticks the ticks to convert
+ */
+void timecode_ticks_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const TimecodeTicks ticks);
+
+/**
+ * convert timecode to nanoseconds, rounded to the nearest nanosecond.
+ * @param t the timecode to convert
+ * @param r frame rate
+ * @return nanoseconds
+ */
+int64_t timecode_time64_to_ns (TimecodeTime64 const * const t, TimecodeRate const * const r);
+
+/**
+ * convert nanoseconds to timecode, rounded to the nearest subframe.
+ * @param t [output] timecode
+ * @param r frame rate
+ * @param ns nanoseconds
+ */
+void timecode_ns_to_time64 (TimecodeTime64 * const t, TimecodeRate const * const r, const int64_t ns);
+
+/**
+ * add two timecodes or durations.
+ * Note: res may point to either of the operands.
+ * @param res [output] t1 + t2
+ * @param r frame rate
+ * @param t1 first operand
+ * @param t2 second operand
+ */
+void timecode_time64_add (TimecodeTime64 * const res, TimecodeRate const * const r, TimecodeTime64 const * const t1, TimecodeTime64 const * const t2);
+
+/**
+ * subtract two timecodes or durations, the result may be negative.
+ * Note: res may point to either of the operands.
+ * @param res [output] t1 - t2
+ * @param r frame rate
+ * @param t1 first operand
+ * @param t2 second operand
+ */
+void timecode_time64_subtract (TimecodeTime64 * const res, TimecodeRate const * const r, TimecodeTime64 const * const t1, TimecodeTime64 const * const t2);
+
+/**
+ * compare two wide timecodes.
+ * @param a first timecode
+ * @param b second timecode
+ * @return +1 if a is later than b, -1 if a is earlier than b, 0 if timecodes are equal
+ */
+int timecode_time64_compare (TimecodeTime64 const * const a, TimecodeTime64 const * const b);
+
+/**
+ * format wide timecode as string "H:MM:SS:FF" with at least two digits
+ * for hours and frames, and a subframe suffix ".S" if the rate has subframes.
+ * @param str [output] formatted string
+ * @param maxsize size of str, \ref TIMECODE_TIME64_STRING_SIZE is always sufficient
+ * @param t the timecode to print
+ * @param r frame rate
+ * @return length of the string, as snprintf(3)
+ */
+size_t timecode_time64_to_string (char *str, const size_t maxsize, TimecodeTime64 const * const t, TimecodeRate const * const r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
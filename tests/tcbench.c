@@ -0,0 +1,656 @@
+/* libtimecode micro-benchmarks
+ *
+ * usage: tcbench [-j] [-q] [-f filter] [-t msec] [-r repeat] [-c baseline.json [-T tolerance]]
+ *  -j  print results as JSON
+ *  -q  quick: only 48kSPS and a shorter measurement time
+ *  -f  only run benchmarks whose name contains one of the given
+ *      comma-separated strings
+ *  -t  minimum measurement time per benchmark in milliseconds (default 50)
+ *  -r  repeat every measurement, report the median and the median absolute
+ *      deviation (MAD) (default 1)
+ *  -c  compare the results against a baseline previously generated with -j,
+ *      exit with non-zero status if a benchmark is slower than the baseline
+ *  -T  relative tolerance for -c (default 0.2 = 20%)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <math.h>
+#include <timecode/timecode.h>
+#include <timecode/timecode_kernels.h>
+#include <timecode/timecode_edl.h>
+#include <timecode/timecode_analyse.h>
+#include <timecode/timecode_range.h>
+#include <timecode/timecode_cursor.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_CYCLES 1
+static uint64_t cycles(void) { return __rdtsc(); }
+#else
+static uint64_t cycles(void) { return 0; }
+#endif
+
+#define NINPUT 1024
+
+static const TimecodeRate rates[] = {
+	{ 24000, 1001, 0, 80},
+	{    24,    1, 0, 80},
+	{ 25000, 1001, 0, 80},
+	{    25,    1, 0, 80},
+	{ 30000, 1001, 0, 80},
+	{ 30000, 1001, 1, 80},
+	{    30,    1, 0, 80},
+	{    30,    1, 1, 80},
+	{ 60000, 1001, 0, 80},
+	{    60,    1, 0, 80},
+	{        10,   1, 0, 1000},
+	{       100,   1, 0, 1000},
+	{      1000,   1, 0, 1000},
+	{   1000000,   1, 0, 1},
+	{1000000000,   1, 0, 1},
+};
+
+static const double samplerates[] = { 44100, 48000, 88200, 96000, 176400, 192000 };
+
+typedef struct {
+	TimecodeRate const *r;
+	double samplerate;
+	TimecodeTime t[NINPUT];
+	Timecode tc[NINPUT];
+	int64_t sample[NINPUT];
+	char str[NINPUT][24];
+	char edl[NINPUT * 96]; ///< CMX3600 EDL with NINPUT events
+	size_t edl_len;
+	TimecodeEdl *edl_table;
+	TimecodeTime seq[NINPUT * 64]; ///< continuous timecode
+	int64_t ns[NINPUT];            ///< tc[] as nanoseconds since the epoch
+	Timecode out[NINPUT];
+} BenchCtx;
+
+typedef struct {
+	const char *name;
+	int per_samplerate; ///< run at every sample-rate
+	void (*run) (BenchCtx *c, size_t n);
+} Benchmark;
+
+static volatile int64_t sink;
+
+/*****************************************************************************
+ * benchmarked functions
+ */
+
+static void b_to_sample(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	for (i = 0; i < n; ++i) {
+		acc += timecode_to_sample(&c->t[i % NINPUT], c->r, c->samplerate);
+	}
+	sink = acc;
+}
+
+static void b_sample_to_time(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeTime t;
+	for (i = 0; i < n; ++i) {
+		timecode_sample_to_time(&t, c->r, c->samplerate, c->sample[i % NINPUT]);
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static void b_to_framenumber(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	for (i = 0; i < n; ++i) {
+		acc += timecode_to_framenumber(&c->t[i % NINPUT], c->r);
+	}
+	sink = acc;
+}
+
+static void b_framenumber_to_time(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeTime t;
+	for (i = 0; i < n; ++i) {
+		timecode_framenumber_to_time(&t, c->r, c->sample[i % NINPUT] / 2000);
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static void b_convert_rate(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeTime t;
+	for (i = 0; i < n; ++i) {
+		timecode_convert_rate(&t, timecode_FPS25, &c->t[i % NINPUT], c->r);
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static void b_time_add(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeTime t;
+	for (i = 0; i < n; ++i) {
+		timecode_time_add(&t, c->r, &c->t[i % NINPUT], &c->t[(i + 1) % NINPUT]);
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static void b_time_compare(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	for (i = 0; i < n; ++i) {
+		acc += timecode_time_compare(c->r, &c->t[i % NINPUT], &c->t[(i + 1) % NINPUT]);
+	}
+	sink = acc;
+}
+
+static void b_datetime_compare(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	for (i = 0; i < n; ++i) {
+		acc += timecode_datetime_compare(c->r, &c->tc[i % NINPUT], &c->tc[(i + 1) % NINPUT]);
+	}
+	sink = acc;
+}
+
+static void b_time_increment(BenchCtx *c, size_t n) {
+	size_t i;
+	TimecodeTime t = c->t[0];
+	for (i = 0; i < n; ++i) {
+		timecode_time_increment(&t, c->r);
+	}
+	sink = t.frame;
+}
+
+static void b_time_decrement(BenchCtx *c, size_t n) {
+	size_t i;
+	TimecodeTime t = c->t[0];
+	for (i = 0; i < n; ++i) {
+		timecode_time_decrement(&t, c->r);
+	}
+	sink = t.frame;
+}
+
+static void b_parse_time(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeTime t;
+	for (i = 0; i < n; ++i) {
+		timecode_parse_time(&t, c->r, c->str[i % NINPUT]);
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static void b_strftimecode(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	char buf[64];
+	for (i = 0; i < n; ++i) {
+		acc += timecode_strftimecode(buf, 64, "%T", &c->tc[i % NINPUT]);
+	}
+	sink = acc;
+}
+
+static void b_time_to_string(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	char buf[16];
+	for (i = 0; i < n; ++i) {
+		timecode_time_to_string(buf, &c->t[i % NINPUT]);
+		acc += buf[10];
+	}
+	sink = acc;
+}
+
+static void b_to_sec(BenchCtx *c, size_t n) {
+	size_t i;
+	double acc = 0;
+	for (i = 0; i < n; ++i) {
+		acc += timecode_to_sec(&c->t[i % NINPUT], c->r);
+	}
+	sink = acc;
+}
+
+static void b_seconds_to_time(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeTime t;
+	for (i = 0; i < n; ++i) {
+		timecode_seconds_to_time(&t, c->r, c->sample[i % NINPUT] / 48000.0);
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static void b_kernel_sample_to_time(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeTime t;
+	TimecodeKernels const * const k = timecode_rate_kernels(c->r);
+	for (i = 0; i < n; ++i) {
+		k->sample_to_time(&t, c->r, c->samplerate, c->sample[i % NINPUT]);
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static void b_kernel_to_sample(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	TimecodeKernels const * const k = timecode_rate_kernels(c->r);
+	for (i = 0; i < n; ++i) {
+		acc += k->to_sample(&c->t[i % NINPUT], c->r, c->samplerate);
+	}
+	sink = acc;
+}
+
+static void b_kernel_time_to_string(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	char buf[16];
+	TimecodeKernels const * const k = timecode_rate_kernels(c->r);
+	for (i = 0; i < n; ++i) {
+		k->time_to_string(buf, &c->t[i % NINPUT]);
+		acc += buf[10];
+	}
+	sink = acc;
+}
+
+/* one op is one event */
+static void b_edl_parse(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	for (i = 0; i < n; i += NINPUT) {
+		TimecodeEdl *edl = timecode_edl_parse(c->edl, c->edl_len, c->r);
+		acc += edl->rec_out[edl->count - 1];
+		timecode_edl_free(edl);
+	}
+	sink = acc;
+}
+
+static void b_edl_format(BenchCtx *c, size_t n) {
+	size_t i;
+	int64_t acc = 0;
+	static char buf[NINPUT * 96];
+	for (i = 0; i < n; i += NINPUT) {
+		acc += timecode_edl_format(c->edl_table, buf, sizeof(buf));
+	}
+	sink = acc;
+}
+
+/* one op is one frame */
+static void b_analyse(BenchCtx *c, size_t n) {
+	const size_t len = sizeof(c->seq) / sizeof(TimecodeTime);
+	size_t i;
+	int64_t acc = 0;
+	for (i = 0; i < n; i += len) {
+		TimecodeAnalysis *a = timecode_analyse(c->seq, len, c->r, 0);
+		acc += a->n_runs;
+		timecode_analysis_free(a);
+	}
+	sink = acc;
+}
+
+/* one op is one record */
+static void b_epoch_to_ns(BenchCtx *c, size_t n) {
+	size_t i;
+	for (i = 0; i < n; i += NINPUT) {
+		timecode_datetime_to_epoch_ns_batch(c->ns, c->tc, NINPUT);
+	}
+	sink = c->ns[0];
+}
+
+static void b_epoch_from_ns(BenchCtx *c, size_t n) {
+	size_t i;
+	for (i = 0; i < n; i += NINPUT) {
+		timecode_epoch_ns_to_datetime_batch(c->out, c->r, 0, c->ns, NINPUT);
+	}
+	sink = c->out[0].t.frame;
+}
+
+/* one op is one frame */
+static void b_range_fill(BenchCtx *c, size_t n) {
+	static TimecodeTime buf[NINPUT * 64];
+	const size_t len = NINPUT * 64;
+	size_t i;
+	for (i = 0; i < n; i += len) {
+		timecode_range_fill(buf, c->r, i % 100000, len, 1);
+	}
+	sink = buf[0].frame;
+}
+
+static void b_range_format(BenchCtx *c, size_t n) {
+	static char buf[NINPUT * 64 * TIMECODE_RANGE_STRIDE];
+	const size_t len = NINPUT * 64;
+	size_t i;
+	for (i = 0; i < n; i += len) {
+		timecode_range_format(buf, c->r, i % 100000, len, '\n', 1);
+	}
+	sink = buf[0];
+}
+
+/* playback in blocks of 64 samples, from every start position */
+static void b_cursor(BenchCtx *c, size_t n) {
+	TimecodeCursor cur;
+	TimecodeTime t;
+	size_t i;
+	int64_t acc = 0;
+	timecode_cursor_init(&cur, c->r, c->samplerate);
+	for (i = 0; i < n; ++i) {
+		timecode_cursor_sample_to_time(&cur, &t, c->sample[(i / 1024) % NINPUT] + 64 * (int64_t)(i % 1024));
+		acc += t.frame;
+	}
+	sink = acc;
+}
+
+static const Benchmark benchmarks[] = {
+	{ "timecode_to_sample",           1, b_to_sample },
+	{ "timecode_sample_to_time",      1, b_sample_to_time },
+	{ "timecode_to_framenumber",      0, b_to_framenumber },
+	{ "timecode_framenumber_to_time", 0, b_framenumber_to_time },
+	{ "timecode_convert_rate",        0, b_convert_rate },
+	{ "timecode_to_sec",              0, b_to_sec },
+	{ "timecode_seconds_to_time",     0, b_seconds_to_time },
+	{ "timecode_time_add",            0, b_time_add },
+	{ "timecode_time_compare",        0, b_time_compare },
+	{ "timecode_datetime_compare",    0, b_datetime_compare },
+	{ "timecode_time_increment",      0, b_time_increment },
+	{ "timecode_time_decrement",      0, b_time_decrement },
+	{ "timecode_parse_time",          0, b_parse_time },
+	{ "timecode_strftimecode",        0, b_strftimecode },
+	{ "timecode_time_to_string",      0, b_time_to_string },
+	{ "kernels/to_sample",            1, b_kernel_to_sample },
+	{ "kernels/sample_to_time",       1, b_kernel_sample_to_time },
+	{ "kernels/time_to_string",       0, b_kernel_time_to_string },
+	{ "edl/parse",                    0, b_edl_parse },
+	{ "edl/format",                   0, b_edl_format },
+	{ "analyse",                      0, b_analyse },
+	{ "epoch/to_ns_batch",            0, b_epoch_to_ns },
+	{ "epoch/from_ns_batch",          0, b_epoch_from_ns },
+	{ "range/fill",                   0, b_range_fill },
+	{ "range/format",                 0, b_range_format },
+	{ "cursor/sample_to_time",        1, b_cursor },
+};
+
+/*****************************************************************************
+ * measurement
+ */
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void prepare(BenchCtx *c, TimecodeRate const * const r, double samplerate) {
+	int i;
+	uint64_t rnd = 42;
+	c->r = r;
+	c->samplerate = samplerate;
+	for (i = 0; i < NINPUT; ++i) {
+		rnd = rnd * 6364136223846793005ULL + 1442695040888963407ULL;
+		c->sample[i] = (rnd >> 20) % (int64_t)(86400 * samplerate);
+		timecode_sample_to_time(&c->t[i], r, samplerate, c->sample[i]);
+		memset(&c->tc[i], 0, sizeof(Timecode));
+		c->tc[i].t = c->t[i];
+		c->tc[i].r = *r;
+		timecode_set_date(&c->tc[i], 2012, 1 + (i % 12), 1 + (i % 28), (i % 5) * 60 - 120);
+		timecode_strftime(c->str[i], 24, "%H:%M:%S:%F.%s", &c->t[i], r);
+	}
+	c->edl_len = sprintf(c->edl, "TITLE: tcbench\nFCM: %s\n", r->drop ? "DROP FRAME" : "NON-DROP FRAME");
+	for (i = 0; i < NINPUT; ++i) {
+		char tc[4][16];
+		timecode_time_to_string(tc[0], &c->t[i]);
+		timecode_time_to_string(tc[1], &c->t[(i + 1) % NINPUT]);
+		timecode_time_to_string(tc[2], &c->t[(i + 2) % NINPUT]);
+		timecode_time_to_string(tc[3], &c->t[(i + 3) % NINPUT]);
+		c->edl_len += sprintf(c->edl + c->edl_len, "%03d  R%06d  V     C        %s %s %s %s\n",
+				i % 1000, i, tc[0], tc[1], tc[2], tc[3]);
+	}
+	c->seq[0] = c->t[0];
+	for (i = 1; i < (int)(sizeof(c->seq) / sizeof(TimecodeTime)); ++i) {
+		c->seq[i] = c->seq[i - 1];
+		timecode_time_increment(&c->seq[i], r);
+	}
+	timecode_datetime_to_epoch_ns_batch(c->ns, c->tc, NINPUT);
+	timecode_edl_free(c->edl_table);
+	c->edl_table = timecode_edl_parse(c->edl, c->edl_len, r);
+}
+
+/* find the iteration count that runs for at least min_time seconds */
+static size_t calibrate(Benchmark const * const b, BenchCtx *c, double min_time) {
+	size_t n = 1024;
+	b->run(c, n); // warm up
+	for (;;) {
+		const double t0 = now();
+		b->run(c, n);
+		const double t1 = now();
+		if (t1 - t0 >= min_time) break;
+		n *= (t1 - t0) < min_time / 16 ? 8 : 2;
+	}
+	return n;
+}
+
+/* run a benchmark n times, return ns/op */
+static double measure(Benchmark const * const b, BenchCtx *c, size_t n, double *cpo) {
+	double t0, t1;
+	uint64_t c0, c1;
+	t0 = now();
+	c0 = cycles();
+	b->run(c, n);
+	c1 = cycles();
+	t1 = now();
+	*cpo = (double)(c1 - c0) / n;
+	return 1e9 * (t1 - t0) / n;
+}
+
+static int dblcmp(const void *a, const void *b) {
+	const double x = *(const double*)a;
+	const double y = *(const double*)b;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/* sorts v[] in place */
+static double median(double *v, int n) {
+	qsort(v, n, sizeof(double), dblcmp);
+	return (n & 1) ? v[n / 2] : .5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+static int match(const char *name, const char *filter) {
+	char tmp[128];
+	const char *p = filter;
+	if (!filter) return 1;
+	while (*p) {
+		size_t len = strcspn(p, ",");
+		if (len > 0 && len < sizeof(tmp)) {
+			memcpy(tmp, p, len);
+			tmp[len] = '\0';
+			if (strstr(name, tmp)) return 1;
+		}
+		p += len;
+		if (*p == ',') ++p;
+	}
+	return 0;
+}
+
+/*****************************************************************************
+ * baseline
+ */
+
+typedef struct {
+	char id[96];
+	double ns;
+	double mad;
+} Baseline;
+
+/* parse the JSON written by -j, one benchmark per line */
+static Baseline *load_baseline(const char *fn, size_t *n_base) {
+	char line[1024];
+	size_t n = 0, alloc = 0;
+	Baseline *base = NULL;
+	FILE *f = fopen(fn, "r");
+	if (!f) {
+		fprintf(stderr, "tcbench: cannot open baseline '%s'\n", fn);
+		exit(2);
+	}
+	while (fgets(line, sizeof(line), f)) {
+		const char *id = strstr(line, "\"id\": \"");
+		const char *ns = strstr(line, "\"ns_per_op\": ");
+		const char *mad = strstr(line, "\"mad_ns\": ");
+		size_t len;
+		if (!id || !ns) continue;
+		id += 7;
+		len = strcspn(id, "\"");
+		if (n == alloc) {
+			alloc = alloc ? alloc * 2 : 64;
+			base = realloc(base, alloc * sizeof(Baseline));
+		}
+		if (len >= sizeof(base[n].id)) len = sizeof(base[n].id) - 1;
+		memcpy(base[n].id, id, len);
+		base[n].id[len] = '\0';
+		base[n].ns = atof(ns + 13);
+		base[n].mad = mad ? atof(mad + 10) : 0;
+		++n;
+	}
+	fclose(f);
+	*n_base = n;
+	return base;
+}
+
+static Baseline const *find_baseline(Baseline const *base, size_t n, const char *id) {
+	size_t i;
+	for (i = 0; i < n; ++i) {
+		if (!strcmp(base[i].id, id)) return &base[i];
+	}
+	return NULL;
+}
+
+static void usage(void) {
+	printf("usage: tcbench [-j] [-q] [-f filter] [-t msec] [-r repeat] [-c baseline.json [-T tolerance]]\n");
+	exit(1);
+}
+
+int main (int argc, char **argv) {
+	int c, json = 0, quick = 0, first = 1, repeat = 1, failed = 0;
+	const char *filter = NULL;
+	const char *baseline = NULL;
+	double min_time = .05;
+	double tolerance = .2;
+	Baseline *base = NULL;
+	size_t n_base = 0;
+	size_t b, ri, si;
+	BenchCtx *ctx = calloc(1, sizeof(BenchCtx));
+
+	while ((c = getopt(argc, argv, "jqf:t:r:c:T:")) != -1) {
+		switch (c) {
+			case 'j': json = 1; break;
+			case 'q': quick = 1; break;
+			case 'f': filter = optarg; break;
+			case 't': min_time = atof(optarg) / 1000.0; break;
+			case 'r': repeat = atoi(optarg); break;
+			case 'c': baseline = optarg; break;
+			case 'T': tolerance = atof(optarg); break;
+			default: usage();
+		}
+	}
+	if (quick) min_time /= 5;
+	if (repeat < 1) repeat = 1;
+	if (baseline) {
+		base = load_baseline(baseline, &n_base);
+	}
+
+	if (json) {
+		printf("{\"library\": \"libtimecode-%s\", \"cycles\": %s, \"repeat\": %d, \"benchmarks\": [\n",
+				LIBTIMECODE_VERSION,
+#ifdef HAVE_CYCLES
+				"true",
+#else
+				"false",
+#endif
+				repeat);
+	} else {
+		printf("%-30s %-10s %7s %10s %8s %14s %10s%s\n", "function", "rate", "SPS", "ns/op", "MAD", "ops/s", "cycles/op",
+				base ? "   baseline" : "");
+	}
+
+	for (b = 0; b < sizeof(benchmarks) / sizeof(Benchmark); ++b) {
+		if (!match(benchmarks[b].name, filter)) continue;
+		for (ri = 0; ri < sizeof(rates) / sizeof(TimecodeRate); ++ri) {
+			for (si = 0; si < sizeof(samplerates) / sizeof(double); ++si) {
+				double ns[repeat], cpo[repeat], dev[repeat];
+				double ns_med, cpo_med, mad;
+				char rate[16], id[96];
+				size_t n;
+				int i;
+				const double sr = benchmarks[b].per_samplerate ? samplerates[si] : 48000;
+
+				if (!benchmarks[b].per_samplerate && si > 0) break;
+				if (quick && sr != 48000) continue;
+
+				prepare(ctx, &rates[ri], sr);
+				n = calibrate(&benchmarks[b], ctx, min_time);
+				for (i = 0; i < repeat; ++i) {
+					ns[i] = measure(&benchmarks[b], ctx, n, &cpo[i]);
+				}
+				ns_med = median(ns, repeat);
+				cpo_med = median(cpo, repeat);
+				for (i = 0; i < repeat; ++i) {
+					dev[i] = fabs(ns[i] - ns_med);
+				}
+				mad = median(dev, repeat);
+
+				timecode_strftime(rate, 16, "%f", &ctx->t[0], &rates[ri]);
+				snprintf(id, sizeof(id), "%s/%s/%.0f", benchmarks[b].name, rate, sr);
+
+				if (json) {
+					printf("%s  {\"id\": \"%s\", \"function\": \"%s\", \"rate\": \"%s\", \"samplerate\": %.0f, \"ns_per_op\": %.3f, \"mad_ns\": %.3f, \"ops_per_sec\": %.0f, \"cycles_per_op\": %.2f}",
+							first ? "" : ",\n", id, benchmarks[b].name, rate, sr, ns_med, mad, 1e9 / ns_med, cpo_med);
+				} else {
+					printf("%-30s %-10s %7.0f %10.2f %8.2f %14.0f %10.2f", benchmarks[b].name, rate, sr, ns_med, mad, 1e9 / ns_med, cpo_med);
+				}
+				first = 0;
+
+				if (base) {
+					Baseline const *bl = find_baseline(base, n_base, id);
+					if (bl) {
+						/* regression: slower than the tolerance allows, and outside the noise */
+						const double noise = 3 * 1.4826 * (mad > bl->mad ? mad : bl->mad);
+						const int slow = ns_med > bl->ns * (1 + tolerance) && ns_med - bl->ns > noise;
+						if (slow) ++failed;
+						if (!json) {
+							printf(" %10.2f %+6.1f%%%s", bl->ns, 100 * (ns_med / bl->ns - 1), slow ? " REGRESSION" : "");
+						} else if (slow) {
+							fprintf(stderr, "tcbench: REGRESSION %s %.2f ns/op, baseline %.2f ns/op\n", id, ns_med, bl->ns);
+						}
+					}
+				}
+				if (!json) {
+					printf("\n");
+				}
+			}
+		}
+	}
+
+	if (json) {
+		printf("\n]}\n");
+	}
+	if (base) {
+		fprintf(stderr, "tcbench: %d benchmark(s) slower than baseline '%s' by more than %.0f%%\n", failed, baseline, 100 * tolerance);
+	}
+	free(base);
+	timecode_edl_free(ctx->edl_table);
+	free(ctx);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+/* libtimecode C++ wrapper test
+ *
+ * compile-time checks, and comparison of the constexpr C++ conversions
+ * with the C library.
+ */
+
+#include <cstdio>
+#include <cinttypes>
+#include <timecode/timecode.hpp>
+
+namespace tc = timecode;
+
+/* compile-time */
+static_assert (tc::Timecode<tc::FPS25> (10, 0, 0, 0).to_sample<48000> ().value == 1728000000, "25fps to sample");
+static_assert (tc::Timecode<tc::FPS2997DF> (0, 1, 0, 2).frames () == 1800, "29.97df frame-number");
+static_assert (tc::Timecode<tc::FPS2997DF>::from_frames (1800).frame () == 2, "29.97df dropped frames");
+static_assert (tc::Timecode<tc::FPS2997DF>::day_frames () == 2589408, "29.97df frames per day");
+static_assert ((tc::Timecode<tc::FPS24> (0, 0, 59, 23, 79) + tc::Timecode<tc::FPS24> (0, 0, 0, 0, 1)) == tc::Timecode<tc::FPS24> (0, 1, 0, 0), "add");
+static_assert (tc::Timecode<tc::FPS25>::from_duration (std::chrono::milliseconds (1500)) == tc::Timecode<tc::FPS25> (0, 0, 1, 12, 40), "chrono");
+static_assert (tc::SamplePos<48000>::from_duration (std::chrono::seconds (2)).value == 96000, "chrono sample");
+static_assert (tc::convert_rate<tc::FPS30> (tc::Timecode<tc::FPS25> (1, 0, 0, 5)) == tc::Timecode<tc::FPS30> (1, 0, 0, 6), "convert");
+
+template <class R, int32_t SR>
+static void check (const char *name) {
+	const TimecodeRate r = R::c_rate ();
+	int64_t s, errors = 0, ties = 0, n = 0;
+	for (s = 0; s < 86400LL * SR; s += 7919 * 13) {
+		TimecodeTime t;
+		timecode_sample_to_time (&t, &r, SR, s);
+		const tc::Timecode<R> x = tc::Timecode<R>::from_sample (tc::SamplePos<SR> (s));
+		if (2 * ((s * R::num * (R::subframes ? R::subframes : 1)) % ((int64_t)SR * R::den)) == (int64_t)SR * R::den) {
+			/* exactly half a subframe, the C result depends on floating-point rounding */
+			++ties;
+		} else if (timecode_time_compare (&r, &t, &x.c_time ())) ++errors;
+		if (R::subframes && 2 * ((t.subframe * (int64_t)SR * R::den) % ((int64_t)R::num * R::subframes)) == (int64_t)R::num * R::subframes) {
+			++ties;
+		} else if (timecode_to_sample (&t, &r, SR) != tc::Timecode<R> (t).template to_sample<SR> ().value) ++errors;
+		t.subframe = 0; // timecode_to_framenumber() rounds to the nearest frame
+		if (timecode_to_framenumber (&t, &r) != tc::Timecode<R> (t).frames ()) ++errors;
+		++n;
+	}
+	printf ("C++ %-8s @ %d: %" PRId64 " differences in %" PRId64 " positions, %" PRId64 " ties\n", name, SR, errors, n, ties);
+}
+
+int main (int argc, char **argv) {
+	printf ("test C++ wrapper\n");
+	check<tc::FPS23976, 48000> ("23.976");
+	check<tc::FPS24, 44100> ("24");
+	check<tc::FPS25, 48000> ("25");
+	check<tc::FPS2997NDF, 48000> ("29.97");
+	check<tc::FPS2997DF, 48000> ("29.97df");
+	check<tc::FPS30DF, 44100> ("30df");
+	check<tc::FPS5994, 96000> ("59.94");
+	return 0;
+}
@@ -8,7 +8,23 @@
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
+#include <math.h>
 #include <timecode/timecode.h>
+#include <timecode/timecode_ltc.h>
+#include <timecode/timecode_mtc.h>
+#include <timecode/timecode_tempo.h>
+#include <timecode/timecode_stats.h>
+#include <timecode/timecode_inline.h>
+#include <timecode/timecode_kernels.h>
+#include <timecode/timecode_rates.h>
+#include <timecode/timecode_bin.h>
+#include <timecode/timecode_index.h>
+#include <timecode/timecode_edl.h>
+#include <timecode/timecode_analyse.h>
+#include <timecode/timecode_sync.h>
+#include <timecode/timecode_time64.h>
+#include <timecode/timecode_range.h>
+#include <timecode/timecode_cursor.h>
 
 int checkfps(int64_t magic, TimecodeRate const * const fps, double samplerate) {
 	TimecodeTime t;
@@ -107,6 +123,769 @@ int checkcmp() {
 	return 0;
 }
 
+int checkltc(TimecodeRate const * const fps, int samplerate, int64_t frames) {
+	TimecodeTime t, start = {1, 0, 0, 0, 0};
+	char tcs[20];
+	int16_t buf[997];
+	int16_t *bufs[1] = { buf };
+	int64_t n = frames * samplerate * fps->den / fps->num;
+	int64_t crossings = 0;
+	int16_t prev = 0;
+	TimecodeLTCEncoder *e = timecode_ltc_encoder_create(fps, samplerate, &start);
+
+	while (n > 0) {
+		size_t i, ns = n > 997 ? 997 : n;
+		timecode_ltc_encoder_render_int16(e, bufs, 1, ns);
+		for (i = 0; i < ns; ++i) {
+			if (buf[i] != prev) ++crossings;
+			prev = buf[i];
+		}
+		n -= ns;
+	}
+	timecode_ltc_encoder_get_time(e, &t);
+	timecode_ltc_encoder_free(e);
+
+	timecode_time_to_string(tcs, &t);
+	/* 80 bit-edges and one extra transition for each '1' bit */
+	printf("LTC %s after %"PRId64" frames, %.2f transitions/frame\n", tcs, frames, (double)crossings / frames);
+	return 0;
+}
+
+int checkmtc(TimecodeRate const * const fps, int samplerate, int blocks) {
+	TimecodeTime start = {1, 0, 59, 20, 0};
+	TimecodeMTCEncoder enc;
+	TimecodeMTCDecoder dec;
+	TimecodeMTCMessage msg[32];
+	Timecode tc;
+	char tcs[20], tce[20];
+	int b, decoded = 0;
+
+	timecode_mtc_encoder_init(&enc, fps, samplerate, &start);
+	timecode_mtc_decoder_init(&dec);
+
+	for (b = 0; b < blocks; ++b) {
+		size_t i, n = timecode_mtc_encoder_process(&enc, 512, msg, 32);
+		for (i = 0; i < n; ++i) {
+			decoded += timecode_mtc_decoder_parse(&dec, msg[i].data, msg[i].size, &tc);
+		}
+	}
+
+	timecode_strftimecode(tcs, 20, "%T", &tc);
+	timecode_time_to_string(tce, &enc.t);
+	printf("MTC %s <> %s @%s, %d updates, direction: %d\n", tcs, tce,
+			fps->drop ? "df" : "ndf", decoded, timecode_mtc_decoder_direction(&dec));
+	return 0;
+}
+
+int checktempo() {
+	TimecodeBBT bbt = {5, 4, 0}, pos = {3, 1, 0};
+	TimecodeBBT notes[3] = {{1, 1, 0}, {2, 1, 960}, {6, 1, 0}};
+	int64_t samples[3];
+	TimecodeTime t;
+	char tcs[20];
+	int64_t s;
+	TimecodeTempoMap *m = timecode_tempomap_create(48000, 120, 4, 4);
+
+	timecode_tempomap_add_tempo(m, &pos, 60);
+	timecode_tempomap_add_meter(m, 5, 6, 8);
+
+	s = timecode_tempomap_bbt_to_sample(m, &bbt);
+	printf("%d|%d|%04d = %"PRId64" <> 648000", bbt.bar, bbt.beat, bbt.tick, s);
+	timecode_tempomap_sample_to_bbt(m, &bbt, s);
+	printf(" = %d|%d|%04d\n", bbt.bar, bbt.beat, bbt.tick);
+
+	timecode_tempomap_bbt_to_time(m, &t, timecode_FPS25, &bbt);
+	timecode_time_to_string(tcs, &t);
+	printf("%d|%d|%04d = %s <> 00:00:13:12\n", bbt.bar, bbt.beat, bbt.tick, tcs);
+
+	timecode_tempomap_bbt_to_sample_batch(m, samples, notes, 3);
+	printf("notes: %"PRId64" %"PRId64" %"PRId64" <> 0 108000 720000, %d segments\n",
+			samples[0], samples[1], samples[2], (int) timecode_tempomap_segments(m));
+
+	timecode_tempomap_free(m);
+	return 0;
+}
+
+int checkremap(int32_t num, int32_t den) {
+	int64_t in[1000], out[1000];
+	int64_t i, errors = 0;
+	TimecodeTime t = {1, 0, 0, 0, 0};
+	char tcs[64];
+
+	for (i = 0; i < 1000; ++i) {
+		in[i] = 172800000 + i * 7919 - 500 * 7919;
+	}
+	timecode_remap_samples(out, in, 1000, num, den);
+	timecode_remap_samples(out, out, 1000, den, num);
+	for (i = 0; i < 1000; ++i) {
+		if (out[i] != in[i]) ++errors;
+	}
+
+	timecode_remap_time(&t, timecode_FPS24, &t, timecode_FPS24, num, den);
+	timecode_strftime(tcs, 64, "%T.%s", &t, timecode_FPS24);
+	printf("remap %d/%d: %"PRId64" round-trip errors, 01:00:00:00 -> %s\n", num, den, errors, tcs);
+	return 0;
+}
+
+int checkticks(TimecodeRate const * const fps, int samplerate) {
+	TimecodeTime t = {10, 9, 59, 29, 71}, x;
+	TimecodeTime64 w, y;
+	char tcs[64];
+	const TimecodeTicks k = timecode_time_to_ticks(&t, fps);
+	const int64_t s = timecode_ticks_to_sample(k, samplerate);
+	int64_t f, errors = 0;
+	int sf;
+
+	timecode_ticks_to_time(&t, fps, k);
+	timecode_strftime(tcs, 64, "%T.%s", &t, fps);
+	printf("ticks %"PRId64" = %s, sample %"PRId64" -> %"PRId64" ticks, frame %"PRId64"\n",
+			k, tcs, s, timecode_sample_to_ticks(s, samplerate), timecode_ticks_to_framenumber(k, fps));
+
+	/* every subframe round-trips, across a minute and a day */
+	for (f = 0; f < 24 * 3600 * 30; f += (f % 1800 < 4) ? 1 : 1777) {
+		timecode_framenumber_to_time(&t, fps, f);
+		for (sf = 0; sf < fps->subframes; ++sf) {
+			t.subframe = sf;
+			timecode_ticks_to_time(&x, fps, timecode_time_to_ticks(&t, fps));
+			if (timecode_time_compare(fps, &t, &x) || x.subframe != sf) ++errors;
+			timecode_time_to_time64(&w, &t);
+			timecode_ticks_to_time64(&y, fps, timecode_time64_to_ticks(&w, fps));
+			if (timecode_time64_compare(&w, &y)) ++errors;
+		}
+	}
+	printf("ticks %d/%d%s: %"PRId64" subframe round-trip errors\n",
+			fps->num, fps->den, fps->drop ? " df" : "", errors);
+	return errors ? -1 : 0;
+}
+
+int checkinline(TimecodeRate const * const fps, int samplerate) {
+	int64_t s, errors = 0;
+	TimecodeTime a, b;
+	for (s = 0; s < 86400LL * samplerate; s += 7919 * 101) {
+		timecode_sample_to_time(&a, fps, samplerate, s);
+		timecode_inline_sample_to_time(&b, fps, samplerate, s);
+		if (timecode_time_compare(fps, &a, &b)) ++errors;
+		if (timecode_to_sample(&a, fps, samplerate) != timecode_inline_to_sample(&a, fps, samplerate)) ++errors;
+		if (timecode_time_increment(&a, fps) != timecode_inline_time_increment(&b, fps)) ++errors;
+		if (timecode_inline_time_compare(fps, &a, &b)) ++errors;
+		if (timecode_time_decrement(&a, fps) != timecode_inline_time_decrement(&b, fps)) ++errors;
+		if (timecode_inline_time_compare(fps, &a, &b)) ++errors;
+	}
+	printf("inline %.2ffps%s @ %d: %"PRId64" differences\n",
+			timecode_rate_to_double(fps), fps->drop ? "df" : "", samplerate, errors);
+	return errors ? -1 : 0;
+}
+
+int checkkernels(TimecodeRate const * const fps, int samplerate) {
+	TimecodeKernels const * const k = timecode_rate_kernels(fps);
+	int64_t s, errors = 0;
+	TimecodeTime a, b;
+	char sa[16], sb[16];
+	for (s = 0; s < 86400LL * samplerate; s += 7919 * 101) {
+		timecode_sample_to_time(&a, fps, samplerate, s);
+		k->sample_to_time(&b, fps, samplerate, s);
+		if (timecode_time_compare(fps, &a, &b)) ++errors;
+		if (timecode_to_sample(&a, fps, samplerate) != k->to_sample(&a, fps, samplerate)) ++errors;
+		if (timecode_to_framenumber(&a, fps) != k->to_framenumber(&a, fps)) ++errors;
+		timecode_framenumber_to_time(&a, fps, s / 100);
+		k->framenumber_to_time(&b, fps, s / 100);
+		if (timecode_time_compare(fps, &a, &b)) ++errors;
+		if (timecode_time_increment(&a, fps) != k->time_increment(&b, fps)) ++errors;
+		if (timecode_time_decrement(&a, fps) != k->time_decrement(&b, fps)) ++errors;
+		timecode_time_to_string(sa, &a);
+		k->time_to_string(sb, &b);
+		if (strcmp(sa, sb)) ++errors;
+	}
+	printf("kernels %-10s @ %d: %"PRId64" differences\n", k->name, samplerate, errors);
+	return errors ? -1 : 0;
+}
+
+int checkrates() {
+	const char * const names[] = { "29.97df", "30000/1001", "2997", "59.94NDF", "ms", "PAL", "24000/1001", "29.97d", "" };
+	const char * const aliases[] = {
+		"23.976", "23.98", "24000/1001", "2398", "23976", "24", "24/1", "24.976",
+		"24.98", "25000/1001", "2498", "24976", "25", "25/1", "pal", "29.97",
+		"29.97ndf", "30000/1001", "2997", "2997ndf", "29.97df", "2997df",
+		"30000/1001df", "ntsc", "30", "30/1", "30ndf", "30df", "59.94", "59.94ndf",
+		"60000/1001", "5994", "60", "60/1", "10", "ds", "100", "cs", "1000", "ms",
+		"1000000", "us", "1000000000", "ns",
+	};
+	TimecodeRateID ids[9];
+	size_t i, found = timecode_rate_lookup_bulk(ids, names, 9);
+	int id, errors = 0;
+	for (i = 0; i < 9; ++i) {
+		TimecodeRate const * const r = timecode_rate_by_id(ids[i]);
+		printf("rate '%s' -> %d %s", names[i], ids[i], ids[i] ? timecode_rate_name(ids[i]) : "(invalid)");
+		if (r) printf(" %d/%d%s sf:%d", r->num, r->den, r->drop ? " df" : "", r->subframes);
+		printf("\n");
+	}
+	for (i = 0; i < sizeof(aliases) / sizeof(char*); ++i) {
+		if (timecode_rate_lookup(aliases[i]) == TIMECODE_RATE_INVALID) ++errors;
+	}
+	for (id = 1; id < TIMECODE_RATE_COUNT; ++id) {
+		if (timecode_rate_lookup(timecode_rate_name(id)) != id) ++errors;
+		if (timecode_rate_id(timecode_rate_by_id(id)) != id) ++errors;
+	}
+	if (timecode_rate_by_id(TIMECODE_RATE_2997DF) != timecode_FPS2997DF) ++errors;
+	printf("rates: found %d of 9, %d errors\n", (int)found, errors);
+	return errors ? -1 : 0;
+}
+
+int checkbin(TimecodeRate const * const fps, int subframes) {
+	static Timecode in[10000], out[10000];
+	static uint8_t buf[2][8192];
+	TimecodeBinWriter w;
+	TimecodeBinReader rd;
+	Timecode tc = {{23, 57, 30, 0, 0}, {2012, 12, 31, 60}, *fps};
+	size_t n, len;
+	int i, errors = 0;
+
+	tc.r.subframes = subframes;
+	for (i = 0; i < 10000; ++i) {
+		if (i % 3000 == 1500) tc.t.subframe = (tc.t.subframe + 7) % (subframes ? subframes : 1);
+		if (i == 5000) timecode_datetime_decrement(&tc);
+		if (i == 7000) tc.t.hour = (tc.t.hour + 3) % 24;
+		in[i] = tc;
+		timecode_datetime_increment(&tc);
+	}
+
+	/* write in two parts */
+	if (timecode_bin_writer_init(&w, buf[0], sizeof(buf[0]), &in[0])) ++errors;
+	n = timecode_bin_write_batch(&w, in, 6000);
+	len = timecode_bin_writer_length(&w);
+	timecode_bin_writer_set_buffer(&w, buf[1], sizeof(buf[1]));
+	n += timecode_bin_write_batch(&w, &in[n], 10000 - n);
+	printf("bin %d/%d%s sf:%d: %d entries, %d bytes (%.4f bytes/entry)\n",
+			fps->num, fps->den, fps->drop ? " df" : "", subframes,
+			(int)n, (int)(len + timecode_bin_writer_length(&w)),
+			(double)(len + timecode_bin_writer_length(&w)) / n);
+
+	if (timecode_bin_reader_init(&rd, buf[0], len)) ++errors;
+	n = timecode_bin_read_batch(&rd, out, 10000);
+	timecode_bin_reader_set_buffer(&rd, buf[1], timecode_bin_writer_length(&w));
+	n += timecode_bin_read_batch(&rd, &out[n], 10000 - n);
+	for (i = 0; i < (int)n; ++i) {
+		if (timecode_time_compare(&in[i].r, &in[i].t, &out[i].t)
+				|| memcmp(&in[i].d, &out[i].d, sizeof(TimecodeDate))) ++errors;
+	}
+	if (n != 10000 || timecode_bin_read(&rd, out) != 0) ++errors;
+	printf("bin: %d entries read, %d errors\n", (int)n, errors);
+	return errors ? -1 : 0;
+}
+
+/* copy an index file with 8 bytes at offset replaced and resized to len,
+ * return 1 if timecode_index_open() rejects the copy */
+static int index_rejects(const char *path, long offset, uint64_t value, long len) {
+	const char *bad = "tctest-bad.idx";
+	static char buf[1 << 16];
+	TimecodeIndex *idx;
+	FILE *f;
+	size_t n;
+
+	if (!(f = fopen(path, "rb"))) return 0;
+	n = fread(buf, 1, sizeof(buf), f);
+	fclose(f);
+	if (offset >= 0 && offset + 8 <= (long)n) memcpy(buf + offset, &value, 8);
+	if (len >= 0 && len < (long)n) n = len;
+	if (!(f = fopen(bad, "wb"))) return 0;
+	fwrite(buf, 1, n, f);
+	fclose(f);
+	idx = timecode_index_open(bad);
+	timecode_index_close(idx);
+	remove(bad);
+	return idx == NULL;
+}
+
+int checkindex(TimecodeRate const * const fps, int nruns) {
+	static TimecodeIndexRun runs[1000];
+	const char *path = "tctest.idx";
+	TimecodeIndex *idx;
+	Timecode tc = {{10, 0, 0, 0, 0}, {2012, 12, 30, 0}, *fps};
+	int64_t frame = 0, f, j;
+	int i, lookups = 0, errors = 0;
+
+	/* runs are stored in reverse order, the index sorts them */
+	for (i = 0; i < nruns; ++i) {
+		TimecodeIndexRun * const r = &runs[nruns - 1 - i];
+		memset(r, 0, sizeof(TimecodeIndexRun));
+		r->frame = frame;
+		r->length = 1000 + (i * 7919) % 20000;
+		r->tc = tc;
+		frame += r->length;
+		for (j = 0; j < r->length + 100 + i; ++j) {
+			timecode_datetime_increment(&tc);
+		}
+	}
+	if (timecode_index_write(path, runs, nruns)) ++errors;
+	idx = timecode_index_open(path);
+	if (!idx) {
+		printf("index: failed to open\n");
+		return -1;
+	}
+
+	for (f = 0; f < frame; f += 997) {
+		int64_t g;
+		++lookups;
+		if (timecode_index_frame_to_timecode(idx, f, &tc)) { ++errors; continue; }
+		if (timecode_index_timecode_to_frame(idx, &tc, &g) || g != f) ++errors;
+	}
+	/* gaps and out of range */
+	if (!timecode_index_frame_to_timecode(idx, frame, &tc)) ++errors;
+	if (!timecode_index_frame_to_timecode(idx, -1, &tc)) ++errors;
+	tc = timecode_index_runs(idx)[nruns - 1].tc;
+	timecode_datetime_decrement(&tc);
+	if (!timecode_index_timecode_to_frame(idx, &tc, &f)) ++errors;
+
+	timecode_index_frame_to_timecode(idx, frame - 1, &tc);
+	printf("index %d/%d%s: %d runs, %.1f hours, last %04d-%02d-%02d %02d:%02d:%02d:%02d, %d lookups, %d errors\n",
+			fps->num, fps->den, fps->drop ? " df" : "",
+			(int)timecode_index_count(idx), frame * fps->den / (3600. * fps->num),
+			tc.d.year, tc.d.month, tc.d.day, tc.t.hour, tc.t.minute, tc.t.second, tc.t.frame,
+			lookups, errors);
+	timecode_index_close(idx);
+
+	/* corrupt files: header is magic, version, page and record size (u32),
+	 * count, runs, order, file size and wrap days (u64), then runs and order */
+	if (nruns == 1) {
+		uint64_t order_offset = 0;
+		FILE *f = fopen(path, "rb");
+		if (!f || fseek(f, 32, SEEK_SET) || fread(&order_offset, 8, 1, f) != 1) ++errors;
+		if (f) fclose(f);
+		if ( index_rejects(path, -1, 0, -1)) ++errors;                            // intact copy
+		if (!index_rejects(path, -1, 0, 4096)) ++errors;                          // truncated
+		if (!index_rejects(path, 24, 0, -1)) ++errors;                            // runs in header
+		if (!index_rejects(path, 24, UINT64_MAX - 4095, -1)) ++errors;            // offset wraps
+		if (!index_rejects(path, 32, 4096 + 1, -1)) ++errors;                     // unaligned
+		if (!index_rejects(path, order_offset + 16, 1, -1)) ++errors;             // run index
+		if (!index_rejects(path, 48, 1000000000, -1)) ++errors;                   // wrap days
+		printf("index: corrupt files, %d errors\n", errors);
+	}
+	remove(path);
+	return errors ? -1 : 0;
+}
+
+/* runs without date that contain later-starting runs, or wrap around midnight */
+int checkindexoverlap(TimecodeRate const * const fps) {
+	TimecodeIndexRun runs[4];
+	const char *path = "tctest.idx";
+	const int64_t fph = 3600 * fps->num / fps->den;
+	TimecodeIndex *idx;
+	Timecode tc;
+	int64_t f;
+	int i, errors = 0;
+	const struct { int h, m; int64_t frame; } lookups[] = {
+		{ 11,  0, 1 * fph },               // inside run 0, after run 1 started
+		{ 10, 32, 2 * fph + 2 * fph / 60 }, // inside run 1, the latest start
+		{ 23, 30, 2 * fph + fph / 12 + fph / 2 }, // run 2, before midnight
+		{  1,  0, 2 * fph + fph / 12 + 2 * fph }, // run 2, after midnight
+		{ 23, 10, 5 * fph + fph / 12 + 10 * fph / 60 }, // run 3, inside run 2
+	};
+
+	memset(runs, 0, sizeof(runs));
+	for (i = 0; i < 4; ++i) runs[i].tc.r = *fps;
+	runs[0].frame = 0;                          runs[0].length = 2 * fph;     runs[0].tc.t.hour = 10;
+	runs[1].frame = 2 * fph;                    runs[1].length = fph / 12;    runs[1].tc.t.hour = 10; runs[1].tc.t.minute = 30;
+	runs[2].frame = 2 * fph + fph / 12;         runs[2].length = 3 * fph;     runs[2].tc.t.hour = 23;
+	runs[3].frame = 5 * fph + fph / 12;         runs[3].length = fph / 4;     runs[3].tc.t.hour = 23;
+	if (timecode_index_write(path, runs, 4) || !(idx = timecode_index_open(path))) {
+		printf("index: failed to write overlapping runs\n");
+		return -1;
+	}
+	for (i = 0; i < (int)(sizeof(lookups) / sizeof(lookups[0])); ++i) {
+		memset(&tc, 0, sizeof(tc));
+		tc.r = *fps;
+		tc.t.hour = lookups[i].h;
+		tc.t.minute = lookups[i].m;
+		if (timecode_index_timecode_to_frame(idx, &tc, &f) || f != lookups[i].frame) ++errors;
+		if (timecode_index_frame_to_timecode(idx, lookups[i].frame, &tc) || tc.t.hour != lookups[i].h || tc.t.minute != lookups[i].m) ++errors;
+	}
+	printf("index overlapping runs: %d errors\n", errors);
+	timecode_index_close(idx);
+	remove(path);
+	return errors ? -1 : 0;
+}
+
+int checkedl(TimecodeRate const * const fps) {
+	const char text[] =
+		"TITLE: tctest\r\n"
+		"FCM: NON-DROP FRAME\r\n"
+		"\r\n"
+		"001  AX       V     C        01:00:00:00 01:00:10:00 00:59:58:00 01:00:08:00\r\n"
+		"* FROM CLIP NAME: shot_001.mov\r\n"
+		"002  BL       V     C        00:00:00:00 00:00:00:00 01:00:08:00 01:00:08:00\r\n"
+		"002  REEL_002 V     D    030 02:10:00:12 02:10:05:12 01:00:08:00 01:00:13:00\r\n"
+		"FCM: DROP FRAME\r\n"
+		"003  REEL_003 AA/V  C        10:09:59;29 10:10:00;02 01:00:13;00 01:00:13;03\r\n"
+		"004  REEL_004 A2    W001 015 23:59:59;29 24:00:00;05 01:00:13;03 01:00:13;09\r\n"
+		"005  BROKEN   V     C        01:00:00:00 01:00:xx:00\r\n"
+		"006  REEL_006 V     C        1:00:00;00 0:1:0;1 00:01:00;00 00:01:00;01\r\n"
+		"M2   REEL_003       048.0                10:09:59:29\r\n";
+	TimecodeEdl *edl = timecode_edl_parse(text, strlen(text), fps);
+	TimecodeEdl *again;
+	char out[2048];
+	size_t i, len;
+	int errors = 0;
+
+	if (!edl) return -1;
+	printf("edl '%s': %d events, %d skipped\n", edl->title, (int)edl->count, (int)edl->skipped);
+	for (i = 0; i < edl->count; ++i) {
+		printf(" %03d %-8s %-5s %c %3d %s %8"PRId64" %8"PRId64" %8"PRId64" %8"PRId64"\n",
+				edl->event[i], edl->reel[i], edl->track[i], edl->transition[i], edl->duration[i],
+				edl->drop[i] ? "DF " : "NDF",
+				edl->src_in[i], edl->src_out[i], edl->rec_in[i], edl->rec_out[i]);
+	}
+
+	/* variable width and dropped labels are parsed like timecode_parse_time() */
+	for (i = 0; i < edl->count && edl->event[i] != 6; ++i);
+	if (i == edl->count) {
+		++errors;
+	} else {
+		const char *tcs[4] = { "1:00:00;00", "0:1:0;1", "00:01:00;00", "00:01:00;01" };
+		const int64_t f[4] = { edl->src_in[i], edl->src_out[i], edl->rec_in[i], edl->rec_out[i] };
+		TimecodeTime t;
+		int k;
+		for (k = 0; k < 4; ++k) {
+			timecode_parse_time(&t, fps, tcs[k]);
+			if (f[k] != timecode_to_framenumber(&t, fps)) ++errors;
+		}
+	}
+
+	len = timecode_edl_format(edl, out, sizeof(out));
+	if (len >= sizeof(out)) ++errors;
+	if (timecode_edl_format(edl, NULL, 0) != len) ++errors;
+	again = timecode_edl_parse(out, len, fps);
+	if (!again || again->count != edl->count || strcmp(again->title, edl->title)) {
+		++errors;
+	} else {
+		for (i = 0; i < edl->count; ++i) {
+			if (   again->src_in[i] != edl->src_in[i] || again->src_out[i] != edl->src_out[i]
+			    || again->rec_in[i] != edl->rec_in[i] || again->rec_out[i] != edl->rec_out[i]
+			    || again->drop[i] != edl->drop[i] || again->duration[i] != edl->duration[i]
+			    || strcmp(again->reel[i], edl->reel[i]) || strcmp(again->track[i], edl->track[i])) {
+				++errors;
+			}
+		}
+	}
+	fwrite(out, 1, len, stdout);
+	printf("edl: round-trip, %d errors\n", errors);
+	timecode_edl_free(again);
+	timecode_edl_free(edl);
+	return errors ? -1 : 0;
+}
+
+int checkanalyse(TimecodeRate const * const fps, int ndf_source) {
+	static TimecodeTime t[20000];
+	TimecodeRate src = *fps;
+	TimecodeAnalysis *a;
+	TimecodeTime c = {23, 58, 30, 10, 0};
+	size_t i, n = 0;
+
+	src.drop = ndf_source ? 0 : fps->drop;
+	for (i = 0; i < 20000; ++i) {
+		if (i == 1000) timecode_time_decrement(&c, &src);             // repeat
+		if (i == 2000) { timecode_time_increment(&c, &src); timecode_time_increment(&c, &src); } // drop 2
+		if (i == 3000) c.hour = 5;                                   // jump
+		if (i == 4000) c.hour -= 1;                                  // jump back
+		if (i == 5000) { t[n++] = (TimecodeTime){25, 0, 0, 0, 0}; } // invalid
+		t[n++] = c;
+		timecode_time_increment(&c, &src);
+	}
+
+	a = timecode_analyse(t, n, fps, 0);
+	if (!a) return -1;
+	printf("analyse %d/%d%s%s: %d frames, %d runs, %d anomalies\n",
+			fps->num, fps->den, fps->drop ? " df" : "", ndf_source ? " (ndf source)" : "",
+			(int)n, (int)a->n_runs, (int)a->n_anomalies);
+	for (i = 0; i < a->n_anomalies && i < 8; ++i) {
+		char tcs[16];
+		timecode_time_to_string(tcs, &t[a->anomalies[i].index]);
+		printf(" %6d %-10s %+6"PRId64" at %s\n", (int)a->anomalies[i].index,
+				timecode_anomaly_name(a->anomalies[i].type), a->anomalies[i].delta, tcs);
+	}
+	if (a->n_anomalies > 8) {
+		printf(" ... %d dropframe\n", (int)a->count[TIMECODE_ANOMALY_DROPFRAME]);
+	}
+	for (i = 0; i < a->n_runs; ++i) {
+		n -= a->runs[i].length;
+	}
+	printf("analyse: %d frames not in any run\n", (int)n);
+	timecode_analysis_free(a);
+	return 0;
+}
+
+int checksync(TimecodeRate const * const fps, int samplerate) {
+	TimecodeSyncStats s;
+	TimecodeSyncSnapshot snap;
+	TimecodeTime t;
+	uint32_t lcg = 1;
+	int64_t i;
+
+	timecode_sync_init(&s, samplerate, 1000);
+	for (i = 0; i < 10000; ++i) {
+		timecode_framenumber_to_time(&t, fps, i);
+		/* local clock is 50 ppm fast, +-20 samples jitter */
+		const int64_t expected = timecode_to_sample(&t, fps, samplerate);
+		lcg = lcg * 1664525 + 1013904223;
+		const int64_t arrival = 1000 + expected + expected / 20000 + (int64_t)(lcg >> 16) % 41 - 20;
+		timecode_sync_update(&s, arrival, &t, fps);
+	}
+	if (timecode_sync_snapshot(&s, &snap)) return -1;
+	printf("sync %d/%d%s: %"PRId64" updates, mean %.2f, stddev %.2f, min %"PRId64", max %"PRId64", drift %.1f ppm\n",
+			fps->num, fps->den, fps->drop ? " df" : "", snap.count,
+			snap.mean, sqrt(snap.variance), snap.min, snap.max, snap.drift * 1e6);
+	printf("sync: p1 %"PRId64", p50 %"PRId64", p99 %"PRId64"\n",
+			timecode_sync_percentile(&snap, 1), timecode_sync_percentile(&snap, 50), timecode_sync_percentile(&snap, 99));
+	return 0;
+}
+
+int checkepoch(TimecodeRate const * const fps) {
+	static Timecode in[100000], out[100000];
+	static int64_t ns[100000];
+	Timecode tc;
+	char tcs[64], tcs2[64];
+	int64_t midnight;
+	int i, n, errors = 0;
+
+	timecode_reset_unixtime(&tc);
+	timecode_copy_rate(&tc, fps);
+	printf("epoch %d/%d%s: 1970-01-01 00:00:00:00 UTC = %"PRId64" ns\n",
+			fps->num, fps->den, fps->drop ? " df" : "", timecode_datetime_to_epoch_ns(&tc));
+
+	timecode_set_date(&tc, 2024, 2, 29, 60);
+	timecode_set_time(&tc, 1, 0, 0, 0, 0);
+	timecode_strftimecode(tcs, 64, "%Y-%m-%d %H:%M:%S:%F %z", &tc);
+	printf("epoch: %s = %"PRId64" ns\n", tcs, timecode_datetime_to_epoch_ns(&tc));
+
+	for (i = 0; i < 100000; ++i) {
+		in[i] = tc;
+		in[i].t.subframe = i % (fps->subframes > 0 ? fps->subframes : 1);
+		timecode_datetime_increment(&tc);
+	}
+	timecode_datetime_to_epoch_ns_batch(ns, in, 100000);
+	timecode_epoch_ns_to_datetime_batch(out, fps, 60, ns, 100000);
+	for (i = 0; i < 100000; ++i) {
+		if (timecode_datetime_compare(fps, &in[i], &out[i]) || in[i].t.subframe != out[i].t.subframe) ++errors;
+		if (i > 0 && ns[i] <= ns[i - 1]) ++errors;
+	}
+	timecode_strftimecode(tcs, 64, "%Y-%m-%d %H:%M:%S:%F.%s %z", &out[99999]);
+	printf("epoch: %d round-trip errors, last %s\n", errors, tcs);
+
+	/* end of the day: labels after the next local midnight map to the next date */
+	timecode_set_date(&tc, 2024, 6, 1, 0);
+	timecode_set_time(&tc, 0, 0, 0, 0, 0);
+	midnight = timecode_datetime_to_epoch_ns(&tc) + 86400LL * 1000000000LL;
+	timecode_set_time(&tc, 23, 50, 0, 0, 0);
+	for (i = 0; i < 100000 && tc.d.day == 1; ++i) {
+		in[i] = tc;
+		timecode_datetime_increment(&tc);
+	}
+	n = i;
+	timecode_datetime_to_epoch_ns_batch(ns, in, n);
+	timecode_epoch_ns_to_datetime_batch(out, fps, 0, ns, n);
+	for (i = 0; i < n; ++i) {
+		if (i > 0 && ns[i] <= ns[i - 1]) ++errors;
+		if (ns[i] < midnight) {
+			if (timecode_datetime_compare(fps, &in[i], &out[i])) ++errors;
+		} else {
+			if (out[i].d.day != 2 || out[i].t.hour != 0) ++errors;
+			/* the next date's timecode is at or before the instant, within one subframe */
+			if (timecode_datetime_to_epoch_ns(&out[i]) > ns[i]) ++errors;
+			timecode_epoch_ns_to_datetime(&tc, fps, 0, timecode_datetime_to_epoch_ns(&out[i]));
+			if (timecode_datetime_compare(fps, &tc, &out[i]) || tc.t.subframe != out[i].t.subframe) ++errors;
+		}
+	}
+	timecode_strftimecode(tcs, 64, "%Y-%m-%d %H:%M:%S:%F", &in[n - 1]);
+	timecode_strftimecode(tcs2, 64, "%Y-%m-%d %H:%M:%S:%F.%s", &out[n - 1]);
+	printf("epoch: %d end-of-day errors, %s -> %s\n", errors, tcs, tcs2);
+	return errors ? -1 : 0;
+}
+
+int checkpts(TimecodeRate const * const fps, int32_t tb_num, int32_t tb_den, int subframes) {
+	static TimecodeTime t[100000], back[100000];
+	static int64_t pts[100000];
+	TimecodeTime x = {0, 0, 0, 0, 0};
+	int64_t p;
+	int i, errors = 0;
+
+	for (i = 0; i < 100000; ++i) {
+		t[i] = x;
+		t[i].subframe = subframes ? (i * 7) % fps->subframes : 0;
+		timecode_time_increment(&x, fps);
+	}
+	timecode_time_to_pts_batch(pts, t, 100000, fps, tb_num, tb_den, TIMECODE_ROUND_UP);
+	timecode_pts_to_time_batch(back, pts, 100000, fps, tb_num, tb_den, TIMECODE_ROUND_DOWN);
+	for (i = 0; i < 100000; ++i) {
+		if (timecode_time_compare(fps, &t[i], &back[i]) || t[i].subframe != back[i].subframe) ++errors;
+	}
+
+	/* 100 hours */
+	x = (TimecodeTime){100, 0, 0, 0, 0};
+	p = timecode_time_to_pts(&x, fps, tb_num, tb_den, TIMECODE_ROUND_NEAREST);
+	timecode_pts_to_time(&x, fps, p, tb_num, tb_den, TIMECODE_ROUND_NEAREST);
+	printf("pts %d/%d%s @ %d/%d: %d round-trip errors, 100:00:00:00 = %"PRId64" -> %d:%02d:%02d:%02d.%02d\n",
+			fps->num, fps->den, fps->drop ? " df" : "", tb_num, tb_den, errors, p,
+			x.hour, x.minute, x.second, x.frame, x.subframe);
+	return errors ? -1 : 0;
+}
+
+int checktime64(TimecodeRate const * const fps, int32_t samplerate) {
+	TimecodeTime t;
+	TimecodeTime64 w, x;
+	char tcs[TIMECODE_TIME64_STRING_SIZE];
+	const int64_t day = 86400LL * fps->num / fps->den;
+	int64_t f, errors = 0;
+
+	/* same as the 32-bit API within a day, timecode_to_sample() rounds drop-frame down */
+	for (f = 0; f < day; f += 997 + day / 100000) {
+		timecode_framenumber_to_time(&t, fps, f);
+		timecode_framenumber_to_time64(&w, fps, f);
+		timecode_time_to_time64(&x, &t);
+		if (timecode_time64_compare(&w, &x)) ++errors;
+		if (timecode_time64_to_framenumber(&w, fps) != timecode_to_framenumber(&t, fps)) ++errors;
+		if (!fps->drop && timecode_time64_to_sample(&w, fps, samplerate) != timecode_to_sample(&t, fps, samplerate)) ++errors;
+	}
+
+	/* one year, round-trip */
+	w = (TimecodeTime64){24 * 366, 59, 59, 0, 0};
+	w.frame = timecode_rate_to_double(fps) - 1;
+	w.subframe = fps->subframes > 0 ? fps->subframes - 1 : 0;
+	timecode_ns_to_time64(&x, fps, timecode_time64_to_ns(&w, fps));
+	if (timecode_time64_compare(&w, &x)) ++errors;
+	timecode_ticks_to_time64(&x, fps, timecode_time64_to_ticks(&w, fps));
+	if ((TIMECODE_TICKS_PER_SECOND * (int64_t)fps->den) % ((int64_t)fps->num * (fps->subframes > 0 ? fps->subframes : 1)) == 0 && timecode_time64_compare(&w, &x)) ++errors;
+	timecode_sample_to_time64(&x, fps, samplerate, timecode_time64_to_sample(&w, fps, samplerate));
+	if (fps->num <= samplerate && fps->subframes == 0 && timecode_time64_compare(&w, &x)) ++errors;
+	timecode_time64_to_string(tcs, sizeof(tcs), &w, fps);
+	printf("time64 %d/%d%s: %"PRId64" errors, %s = %"PRId64" ns\n",
+			fps->num, fps->den, fps->drop ? " df" : "", errors, tcs, timecode_time64_to_ns(&w, fps));
+
+	/* negative duration */
+	timecode_framenumber_to_time64(&x, fps, 0);
+	timecode_framenumber_to_time64(&w, fps, 1);
+	timecode_time64_subtract(&x, fps, &x, &w);
+	timecode_time64_to_string(tcs, sizeof(tcs), &x, fps);
+	printf("time64: 0 - 1 frame = %s, %"PRId64" frames\n", tcs, timecode_time64_to_framenumber(&x, fps));
+	return errors ? -1 : 0;
+}
+
+int checkboundaries(TimecodeRate const * const fps, double samplerate) {
+	size_t offsets[256];
+	TimecodeTime tc[256], t, prev;
+	int64_t start = 0, s;
+	int i, errors = 0, total = 0;
+	uint32_t lcg = 7;
+
+	for (i = 0; i < 400; ++i) {
+		const size_t n = timecode_frame_boundaries(fps, samplerate, start, 4096, offsets, tc, 256);
+		size_t j = 0;
+		total += n;
+		/* compare with every sample */
+		if (start > 0) timecode_sample_to_time(&prev, fps, samplerate, start - 1);
+		for (s = start; s < start + 4096; ++s) {
+			timecode_sample_to_time(&t, fps, samplerate, s);
+			if (s == 0 || t.frame != prev.frame || t.second != prev.second || t.minute != prev.minute || t.hour != prev.hour) {
+				if (j >= n || offsets[j] != (size_t)(s - start) || timecode_time_compare(fps, &t, &tc[j]) || t.subframe != tc[j].subframe) ++errors;
+				++j;
+			}
+			prev = t;
+		}
+		if (j != n) ++errors;
+		lcg = lcg * 1664525 + 1013904223;
+		if (i & 1) {
+			start += 4096;
+		} else if (i & 2) {
+			/* cross an hour, the last half subframe before it carries into the hour */
+			const TimecodeTime h = { 1 + (i / 4) % 24, 0, 0, 0, 0 };
+			start = timecode_to_sample(&h, fps, samplerate) - 3000;
+		} else {
+			start = (int64_t)(lcg >> 4) % (int64_t)(86000 * samplerate);
+		}
+	}
+	printf("boundaries %d/%d%s @ %.0f: %d boundaries, %d errors\n",
+			fps->num, fps->den, fps->drop ? " df" : "", samplerate, total, errors);
+	return errors ? -1 : 0;
+}
+
+int checkrange(TimecodeRate const * const fps, int64_t first, size_t n, int n_threads) {
+	static TimecodeTime out[400000];
+	static char txt[400000 * TIMECODE_RANGE_STRIDE];
+	TimecodeTime t;
+	char tcs[12];
+	size_t i;
+	int errors = 0;
+
+	if (timecode_range_fill(out, fps, first, n, n_threads)) return -1;
+	if (timecode_range_format(txt, fps, first, n, '\n', n_threads)) return -1;
+	for (i = 0; i < n; ++i) {
+		timecode_framenumber_to_time(&t, fps, first + i);
+		timecode_time_to_string(tcs, &t);
+		if (timecode_time_compare(fps, &t, &out[i]) || out[i].subframe != 0) ++errors;
+		if (memcmp(tcs, txt + i * TIMECODE_RANGE_STRIDE, 11) || txt[i * TIMECODE_RANGE_STRIDE + 11] != '\n') ++errors;
+	}
+	printf("range %d/%d%s: %d frames from %.11s to %.11s, %d threads, %d errors\n",
+			fps->num, fps->den, fps->drop ? " df" : "", (int)n, txt, txt + (n - 1) * TIMECODE_RANGE_STRIDE, n_threads, errors);
+	return errors ? -1 : 0;
+}
+
+int checkcursor(TimecodeRate const * const fps, double samplerate) {
+	TimecodeCursor c;
+	TimecodeTime t, ref;
+	int64_t s = 0;
+	uint32_t lcg = 3;
+	int i, errors = 0;
+
+	timecode_cursor_init(&c, fps, samplerate);
+	for (i = 0; i < 1000000; ++i) {
+		lcg = lcg * 1664525 + 1013904223;
+		switch ((lcg >> 24) & 15) {
+			case 0: /* locate */
+				s = (lcg >> 2) % (int64_t)(86400 * samplerate);
+				break;
+			case 1: /* small step back */
+				s -= (lcg >> 8) & 63;
+				break;
+			case 2: case 3: case 4: /* same position */
+				break;
+			default: /* playback, one block */
+				s += 256;
+				break;
+		}
+		timecode_cursor_sample_to_time(&c, &t, s);
+		timecode_sample_to_time(&ref, fps, samplerate, s);
+		if (timecode_time_compare(fps, &t, &ref) || t.subframe != ref.subframe) ++errors;
+	}
+	printf("cursor %d/%d%s @ %.0f: %d errors, %"PRIu64" hits, %"PRIu64" near, %"PRIu64" misses, hit-rate %.3f\n",
+			fps->num, fps->den, fps->drop ? " df" : "", samplerate, errors,
+			c.hits, c.near, c.misses, timecode_cursor_hit_rate(&c));
+	return errors ? -1 : 0;
+}
+
+int checkstats(TimecodeRate const * const fps, int samplerate) {
+	TimecodeStats st;
+	TimecodeTime t = {23, 59, 59, 29, 79};
+	int i;
+
+	timecode_stats_reset();
+	if (timecode_stats_snapshot(&st)) {
+		printf("stats: instrumentation is not enabled\n");
+		return 0;
+	}
+	for (i = 0; i < 100; ++i) {
+		timecode_sample_to_time(&t, fps, samplerate, timecode_to_sample(&t, fps, samplerate));
+	}
+	timecode_time_increment(&t, fps);
+	timecode_stats_snapshot(&st);
+	for (i = 0; i < TIMECODE_STAT_COUNT; ++i) {
+		if (st.count[i] == 0) continue;
+		printf("stats: %-24s %6"PRIu64, timecode_stats_name(i), st.count[i]);
+		if (st.timing && st.cycles[i] > 0) {
+			printf(" %8.1f cycles", (double) st.cycles[i] / st.count[i]);
+		}
+		printf("\n");
+	}
+	return 0;
+}
+
 int main (int argc, char **argv) {
 	const TimecodeRate tcfpsUS      = {   1000000,   1, 0, 1};
 	const TimecodeRate tcfps2997ndf = { 30000, 1001, 0, 80};
@@ -115,6 +894,7 @@ int main (int argc, char **argv) {
   int64_t magic = 964965602; // 05:34:43:11 @29.97ndf, 48kSPS
   //int64_t magic = 1601568888; //
 	Timecode tc;
+	int failed = 0;
 	memset(&tc, 0, sizeof(Timecode));
 
 	checkfps(259199740, timecode_FPS2997DF, 48000);
@@ -237,5 +1017,108 @@ int main (int argc, char **argv) {
 	timecode_parse_time(&tc.t, &tc.r, "05:34:43:11");
 	printf("%"PRId64"  <> 964965602\n", timecode_to_sample(&tc.t, &tc.r, 48000));
 
-	return 0;
+	printf("test LTC encoder\n");
+	checkltc(timecode_FPS25, 48000, 1500);
+	checkltc(timecode_FPS2997DF, 44100, 18000);
+
+	printf("test MTC encoder/decoder\n");
+	checkmtc(timecode_FPS25, 48000, 150);
+	checkmtc(timecode_FPS2997DF, 48000, 150);
+
+	printf("test tempo map\n");
+	checktempo();
+
+	printf("test remap\n");
+	checkremap(1001, 1000);
+	checkremap(25, 24);
+
+	printf("test ticks\n");
+	if (checkticks(timecode_FPS2997DF, 48000)) ++failed;
+	if (checkticks(timecode_FPS25, 44100)) ++failed;
+	if (checkticks(timecode_FPS23976, 48000)) ++failed;
+	if (checkticks(timecode_FPS24976, 48000)) ++failed;
+	if (checkticks(timecode_FPSMS, 48000)) ++failed;
+
+	printf("test inline\n");
+	if (checkinline(timecode_FPS2997DF, 48000)) ++failed;
+	if (checkinline(timecode_FPS23976, 44100)) ++failed;
+	if (checkinline(timecode_FPS25, 48000)) ++failed;
+
+	printf("test kernels\n");
+	if (checkkernels(timecode_FPS2997DF, 48000)) ++failed;
+	if (checkkernels(timecode_FPS23976, 44100)) ++failed;
+	if (checkkernels(timecode_FPS25, 48000)) ++failed;
+	if (checkkernels(timecode_FPSMS, 48000)) ++failed;
+	if (checkkernels(&tcfps30df, 96000)) ++failed;
+	{
+		const TimecodeRate odd = { 48, 1, 0, 100 };
+		if (checkkernels(&odd, 48000)) ++failed;
+	}
+
+	printf("test rate registry\n");
+	if (checkrates()) ++failed;
+
+	printf("test binary stream\n");
+	if (checkbin(timecode_FPS25, 0)) ++failed;
+	if (checkbin(timecode_FPS2997DF, 80)) ++failed;
+	if (checkbin(&tcfps30df, 0)) ++failed;
+
+	printf("test frame index\n");
+	if (checkindex(timecode_FPS2997DF, 1000)) ++failed;
+	if (checkindex(timecode_FPS25, 1)) ++failed;
+	if (checkindexoverlap(timecode_FPS25)) ++failed;
+
+	printf("test EDL\n");
+	if (checkedl(timecode_FPS2997DF)) ++failed;
+
+	printf("test analyse\n");
+	if (checkanalyse(timecode_FPS25, 0)) ++failed;
+	if (checkanalyse(timecode_FPS2997DF, 0)) ++failed;
+	if (checkanalyse(timecode_FPS2997DF, 1)) ++failed;
+
+	printf("test sync statistics\n");
+	if (checksync(timecode_FPS2997DF, 48000)) ++failed;
+
+	printf("test epoch\n");
+	if (checkepoch(timecode_FPS2997DF)) ++failed;
+	if (checkepoch(&tcfps2997ndf)) ++failed;
+	if (checkepoch(timecode_FPS23976)) ++failed;
+	if (checkepoch(&tcfpsUS)) ++failed;
+
+	printf("test pts\n");
+	if (checkpts(timecode_FPS2997DF, 1, 90000, 1)) ++failed;
+	if (checkpts(timecode_FPS23976, 1, 48000, 1)) ++failed;
+	if (checkpts(timecode_FPS2997DF, 1001, 30000, 0)) ++failed;
+	if (checkpts(timecode_FPS25, 1, 1000, 0)) ++failed;
+
+	printf("test time64\n");
+	if (checktime64(timecode_FPS2997DF, 48000)) ++failed;
+	if (checktime64(timecode_FPS25, 44100)) ++failed;
+	if (checktime64(&tcfpsUS, 48000)) ++failed;
+
+	printf("test frame boundaries\n");
+	if (checkboundaries(timecode_FPS2997DF, 48000)) ++failed;
+	if (checkboundaries(timecode_FPS23976, 44100)) ++failed;
+	if (checkboundaries(timecode_FPS25, 48000)) ++failed;
+	if (checkboundaries(&tcfps2997ndf, 96000)) ++failed;
+	if (checkboundaries(timecode_FPSMS, 48000)) ++failed;
+
+	printf("test range\n");
+	if (checkrange(timecode_FPS2997DF, 17980, 100, 1)) ++failed;
+	if (checkrange(timecode_FPS2997DF, 2589000, 400000, 4)) ++failed;
+	if (checkrange(timecode_FPS25, 0, 400000, 3)) ++failed;
+
+	printf("test cursor\n");
+	if (checkcursor(timecode_FPS2997DF, 48000)) ++failed;
+	if (checkcursor(timecode_FPS23976, 44100)) ++failed;
+	if (checkcursor(&tcfps2997ndf, 48000)) ++failed;
+	if (checkcursor(&tcfps30df, 96000)) ++failed;
+
+	printf("test stats\n");
+	checkstats(timecode_FPS2997DF, 48000);
+
+	if (failed) {
+		printf("%d checks failed\n", failed);
+	}
+	return failed ? 1 : 0;
 }
@@ -0,0 +1,332 @@
+/* libtimecode exhaustive round-trip verifier
+ *
+ * For every frame and subframe of 24 hours, at every frame-rate and common
+ * sample-rate, check that
+ *   timecode_sample_to_time (timecode_to_sample (t)) == t
+ *
+ * usage: tcverify [-q] [-j threads] [-s stride] [-f filter]
+ *  -q  quick mode: only every 997th frame (all subframes), for "make check"
+ *  -j  number of worker threads (default: number of online CPUs)
+ *  -s  only check every Nth frame (default 1, or 997 with -q)
+ *  -f  only verify rates whose label (e.g. "29.97df") contains the filter
+ *
+ * The work is split into chunks of frames which are distributed evenly over
+ * the worker threads. A thread that runs out of work steals half of the
+ * remaining chunks from the thread with the most work left.
+ *
+ * Rate/sample-rate combinations where a subframe is shorter than a
+ * sample can not round-trip and are skipped.
+ *
+ * exit status: 0 if all conversions round-trip, 1 otherwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <timecode/timecode.h>
+
+#define CHUNK_FRAMES 4096
+#define MAX_THREADS 256
+
+static const TimecodeRate rates[] = {
+	{ 24000, 1001, 0, 80},
+	{    24,    1, 0, 80},
+	{ 25000, 1001, 0, 80},
+	{    25,    1, 0, 80},
+	{ 30000, 1001, 0, 80},
+	{ 30000, 1001, 1, 80},
+	{    30,    1, 0, 80},
+	{    30,    1, 1, 80},
+	{ 60000, 1001, 0, 80},
+	{    60,    1, 0, 80},
+	{        10,   1, 0, 1000},
+	{       100,   1, 0, 1000},
+	{      1000,   1, 0, 1000},
+	{   1000000,   1, 0, 1},
+	{1000000000,   1, 0, 1},
+};
+
+static const double samplerates[] = { 44100, 48000, 88200, 96000, 176400, 192000 };
+
+typedef struct {
+	TimecodeRate const *r;
+	double samplerate;
+	char label[16];
+	int64_t frames;      ///< number of frames in 24h
+	int64_t chunk0;      ///< index of the first chunk
+	int64_t nchunks;
+	/* result */
+	pthread_mutex_t lock;
+	int64_t checked;
+	int64_t mismatches;
+	int64_t first;       ///< frame-number of the first mismatch, -1: none
+	TimecodeTime expect; ///< timecode of the first mismatch
+	TimecodeTime got;
+	int64_t sample;
+} Job;
+
+typedef struct {
+	pthread_mutex_t lock;
+	int64_t next; ///< next chunk to process
+	int64_t end;  ///< end of the range owned by this worker
+	pthread_t thread;
+} Worker;
+
+static Job *jobs = NULL;
+static int n_jobs = 0;
+static int64_t n_chunks = 0;
+static Worker workers[MAX_THREADS];
+static int n_workers = 1;
+static int64_t stride = 1;
+
+/*****************************************************************************
+ * reference frame-number to timecode, independent of the library
+ */
+
+static void frames_to_time(TimecodeTime *t, TimecodeRate const * const r, int64_t frames) {
+	const int64_t fps_i = (r->num + r->den - 1) / r->den;
+	if (r->drop) {
+		const int64_t f10 = 600 * fps_i - 18;
+		const int64_t f1  =  60 * fps_i - 2;
+		const int64_t D = frames / f10;
+		const int64_t M = frames % f10;
+		frames += 18 * D + 2 * ((M - 2) / f1);
+	}
+	t->frame  =    frames % fps_i;
+	t->second =   (frames / fps_i) % 60;
+	t->minute =  ((frames / fps_i) / 60) % 60;
+	t->hour   = (((frames / fps_i) / 60) / 60);
+	t->subframe = 0;
+}
+
+static int64_t frames_per_day(TimecodeRate const * const r) {
+	const int64_t fps_i = (r->num + r->den - 1) / r->den;
+	if (r->drop) {
+		return 24 * 6 * (600 * fps_i - 18);
+	}
+	return 24 * 3600 * fps_i;
+}
+
+static int time_equal(TimecodeTime const * const a, TimecodeTime const * const b) {
+	return a->hour == b->hour && a->minute == b->minute && a->second == b->second
+		&& a->frame == b->frame && a->subframe == b->subframe;
+}
+
+/*****************************************************************************
+ * verification
+ */
+
+static void verify_chunk(int64_t chunk) {
+	int lo = 0, hi = n_jobs - 1;
+	int64_t f, f_end, checked = 0, mismatches = 0;
+	Job *j;
+
+	/* find the job that this chunk belongs to */
+	while (lo < hi) {
+		const int mid = (lo + hi + 1) / 2;
+		if (jobs[mid].chunk0 <= chunk) lo = mid; else hi = mid - 1;
+	}
+	j = &jobs[lo];
+
+	f = (chunk - j->chunk0) * CHUNK_FRAMES * stride;
+	f_end = f + CHUNK_FRAMES * stride;
+	if (f_end > j->frames) f_end = j->frames;
+
+	for (; f < f_end; f += stride) {
+		TimecodeTime t, rt;
+		int32_t sf;
+		frames_to_time(&t, j->r, f);
+		for (sf = 0; sf < (j->r->subframes > 0 ? j->r->subframes : 1); ++sf) {
+			int64_t s;
+			t.subframe = sf;
+			s = timecode_to_sample(&t, j->r, j->samplerate);
+			timecode_sample_to_time(&rt, j->r, j->samplerate, s);
+			++checked;
+			if (time_equal(&t, &rt)) continue;
+			if (mismatches++ > 0) continue;
+			/* only the first mismatch in this chunk is of interest */
+			pthread_mutex_lock(&j->lock);
+			if (j->first < 0 || f < j->first) {
+				j->first = f;
+				j->expect = t;
+				j->got = rt;
+				j->sample = s;
+			}
+			pthread_mutex_unlock(&j->lock);
+		}
+	}
+
+	pthread_mutex_lock(&j->lock);
+	j->checked += checked;
+	j->mismatches += mismatches;
+	pthread_mutex_unlock(&j->lock);
+}
+
+/* take half of the remaining chunks from the worker with most work left */
+static int steal(Worker *self) {
+	int i, victim = -1;
+	int64_t most = 0;
+	for (i = 0; i < n_workers; ++i) {
+		int64_t left;
+		if (&workers[i] == self) continue;
+		/* a hint without the lock, the owner may change next and end meanwhile */
+		left = __atomic_load_n(&workers[i].end, __ATOMIC_RELAXED)
+		     - __atomic_load_n(&workers[i].next, __ATOMIC_RELAXED);
+		if (left > most) {
+			most = left;
+			victim = i;
+		}
+	}
+	if (victim < 0) return -1;
+
+	/* lock in a fixed order, two idle workers may try to steal from each other */
+	if (&workers[victim] < self) {
+		pthread_mutex_lock(&workers[victim].lock);
+		pthread_mutex_lock(&self->lock);
+	} else {
+		pthread_mutex_lock(&self->lock);
+		pthread_mutex_lock(&workers[victim].lock);
+	}
+	most = workers[victim].end - workers[victim].next;
+	if (most > 0) {
+		const int64_t take = (most + 1) / 2;
+		/* next and end are written under the lock, but read without it above */
+		__atomic_store_n(&self->end, workers[victim].end, __ATOMIC_RELAXED);
+		__atomic_store_n(&self->next, workers[victim].end - take, __ATOMIC_RELAXED);
+		__atomic_store_n(&workers[victim].end, workers[victim].end - take, __ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&workers[victim].lock);
+	pthread_mutex_unlock(&self->lock);
+	return most > 0 ? 0 : steal(self);
+}
+
+static void *worker_thread(void *arg) {
+	Worker *w = (Worker*) arg;
+	for (;;) {
+		int64_t chunk = -1;
+		pthread_mutex_lock(&w->lock);
+		if (w->next < w->end) {
+			chunk = w->next;
+			__atomic_store_n(&w->next, chunk + 1, __ATOMIC_RELAXED);
+		}
+		pthread_mutex_unlock(&w->lock);
+		if (chunk < 0) {
+			if (steal(w)) break;
+			continue;
+		}
+		verify_chunk(chunk);
+	}
+	return NULL;
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void usage(void) {
+	printf("usage: tcverify [-q] [-j threads] [-s stride] [-f filter]\n");
+	exit(1);
+}
+
+int main (int argc, char **argv) {
+	int c, i, quick = 0, failed = 0;
+	const char *filter = NULL;
+	size_t ri, si;
+	int64_t total = 0;
+	double t0, t1;
+
+	n_workers = sysconf(_SC_NPROCESSORS_ONLN);
+	stride = 0;
+
+	while ((c = getopt(argc, argv, "qj:s:f:")) != -1) {
+		switch (c) {
+			case 'q': quick = 1; break;
+			case 'j': n_workers = atoi(optarg); break;
+			case 's': stride = atoll(optarg); break;
+			case 'f': filter = optarg; break;
+			default: usage();
+		}
+	}
+	if (n_workers < 1) n_workers = 1;
+	if (n_workers > MAX_THREADS) n_workers = MAX_THREADS;
+	if (stride < 1) stride = quick ? 997 : 1;
+
+	jobs = calloc(sizeof(rates) / sizeof(TimecodeRate) * sizeof(samplerates) / sizeof(double), sizeof(Job));
+
+	for (ri = 0; ri < sizeof(rates) / sizeof(TimecodeRate); ++ri) {
+		TimecodeTime t0 = {0, 0, 0, 0, 0};
+		char label[16];
+		timecode_strftime(label, 16, "%f", &t0, &rates[ri]);
+		if (filter && !strstr(label, filter)) continue;
+		for (si = 0; si < sizeof(samplerates) / sizeof(double); ++si) {
+			Job *j = &jobs[n_jobs];
+			const int32_t sub = rates[ri].subframes > 0 ? rates[ri].subframes : 1;
+			if ((double)rates[ri].num * sub > samplerates[si] * rates[ri].den) {
+				printf("%-10s %7.0f  skipped, subframe is shorter than a sample\n", label, samplerates[si]);
+				continue;
+			}
+			j->r = &rates[ri];
+			j->samplerate = samplerates[si];
+			strcpy(j->label, label);
+			j->frames = frames_per_day(&rates[ri]);
+			j->nchunks = ((j->frames + stride - 1) / stride + CHUNK_FRAMES - 1) / CHUNK_FRAMES;
+			j->chunk0 = n_chunks;
+			j->first = -1;
+			pthread_mutex_init(&j->lock, NULL);
+			n_chunks += j->nchunks;
+			++n_jobs;
+		}
+	}
+
+	if (n_jobs == 0) {
+		free(jobs);
+		return 0;
+	}
+
+	/* initial even distribution */
+	for (i = 0; i < n_workers; ++i) {
+		pthread_mutex_init(&workers[i].lock, NULL);
+		workers[i].next = n_chunks * i / n_workers;
+		workers[i].end = n_chunks * (i + 1) / n_workers;
+	}
+
+	t0 = now();
+	for (i = 0; i < n_workers; ++i) {
+		pthread_create(&workers[i].thread, NULL, worker_thread, &workers[i]);
+	}
+	for (i = 0; i < n_workers; ++i) {
+		pthread_join(workers[i].thread, NULL);
+	}
+	t1 = now();
+
+	for (i = 0; i < n_jobs; ++i) {
+		Job *j = &jobs[i];
+		total += j->checked;
+		if (j->mismatches == 0) {
+			printf("%-10s %7.0f  OK   %12" PRId64 " conversions\n", j->label, j->samplerate, j->checked);
+			continue;
+		}
+		++failed;
+		printf("%-10s %7.0f  FAIL %12" PRId64 " conversions, %" PRId64 " mismatches, first: "
+				"%02d:%02d:%02d:%02d.%02d -> sample %" PRId64 " -> %02d:%02d:%02d:%02d.%02d\n",
+				j->label, j->samplerate, j->checked, j->mismatches,
+				j->expect.hour, j->expect.minute, j->expect.second, j->expect.frame, j->expect.subframe,
+				j->sample,
+				j->got.hour, j->got.minute, j->got.second, j->got.frame, j->got.subframe);
+	}
+
+	printf("%" PRId64 " conversions in %.2f sec using %d threads, %.1f M/s\n",
+			total, t1 - t0, n_workers, total / (t1 - t0) / 1e6);
+	if (failed) {
+		printf("%d of %d rate/sample-rate combinations failed to round-trip\n", failed, n_jobs);
+	}
+
+	free(jobs);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,477 @@
+/* timecode - bulk timecode conversion
+ *
+ * usage: timecode [-r rate] [-R rate] [-s samplerate] [-j threads] [-o file] <command> [file...]
+ *
+ * commands, one value per input line:
+ *  s2t      audio sample number to timecode
+ *  t2s      timecode to audio sample number
+ *  t2sec    timecode to seconds
+ *  convert  timecode at -r rate to timecode at -R rate
+ *  fmt      normalize timecode to HH:MM:SS:FF
+ *
+ * options:
+ *  -r  frame-rate of the input, e.g. "25", "29.97df", "30000/1001" (default 25)
+ *  -R  frame-rate of the output for "convert" (default: same as -r)
+ *  -s  sample-rate for "s2t" and "t2s" (default 48000)
+ *  -j  number of worker threads (default 1)
+ *  -o  write output to file instead of stdout
+ *
+ * Files are mapped, standard input is read in large blocks. Every block
+ * is split at line boundaries over the worker threads, each thread
+ * formats into a private buffer, the buffers are written in input order.
+ *
+ * Lines that can not be parsed are copied to the output unchanged,
+ * and counted on stderr.
+ *
+ * exit status: 0 on success, 1 on usage error, 2 on I/O error.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <timecode/timecode.h>
+#include <timecode/timecode_kernels.h>
+#include <timecode/timecode_rates.h>
+
+#define BLOCK_SIZE (4 << 20) ///< input bytes per thread and batch
+#define MAX_THREADS 64
+#define MAX_LINE 64          ///< maximum output length of a converted line
+
+typedef struct Ctx Ctx;
+
+/* convert one line (without newline), return output length or -1 */
+typedef int (*ConvertFn) (Ctx const * const c, const char *s, const size_t len, char *out);
+
+struct Ctx {
+	TimecodeRate r_in;
+	TimecodeRate r_out;
+	TimecodeKernels const *k_in;
+	TimecodeKernels const *k_out;
+	double samplerate;
+	ConvertFn convert;
+};
+
+typedef struct {
+	Ctx const *ctx;
+	const char *in;
+	size_t len;
+	char *out;
+	size_t out_len;
+	size_t out_size;
+	size_t bad;
+	pthread_t thread;
+} Job;
+
+/*****************************************************************************
+ * parse and format
+ */
+
+static inline int is_digit(const char c) {
+	return c >= '0' && c <= '9';
+}
+
+static inline int is_space(const char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static void trim(const char **s, size_t *len) {
+	while (*len > 0 && is_space(**s)) { ++*s; --*len; }
+	while (*len > 0 && is_space((*s)[*len - 1])) --*len;
+}
+
+static int parse_int(const char *s, size_t len, int64_t *v) {
+	int neg = 0;
+	int64_t x = 0;
+	trim(&s, &len);
+	if (len > 0 && (*s == '-' || *s == '+')) {
+		neg = *s == '-';
+		++s; --len;
+	}
+	if (len == 0 || len > 18) return -1;
+	for (; len > 0; ++s, --len) {
+		if (!is_digit(*s)) return -1;
+		x = x * 10 + (*s - '0');
+	}
+	*v = neg ? -x : x;
+	return 0;
+}
+
+static int parse_tc(const char *s, size_t len, TimecodeTime *t, TimecodeRate const * const r) {
+	char buf[32];
+	size_t i;
+	trim(&s, &len);
+	if (len == 11 && is_digit(s[0]) && is_digit(s[1]) && is_digit(s[3]) && is_digit(s[4])
+	    && is_digit(s[6]) && is_digit(s[7]) && is_digit(s[9]) && is_digit(s[10])
+	    && (s[2] == ':') && (s[5] == ':') && (s[8] == ':' || s[8] == ';')) {
+		const int32_t fps = (r->num + r->den - 1) / r->den;
+		t->hour     = (s[0] - '0') * 10 + s[1] - '0';
+		t->minute   = (s[3] - '0') * 10 + s[4] - '0';
+		t->second   = (s[6] - '0') * 10 + s[7] - '0';
+		t->frame    = (s[9] - '0') * 10 + s[10] - '0';
+		t->subframe = 0;
+		if (t->hour < 24 && t->minute < 60 && t->second < 60 && t->frame < fps
+		    && !(r->drop && t->minute % 10 && t->second == 0 && t->frame < 2)) {
+			return 0;
+		}
+	}
+	/* anything else, including out-of-range values, is left to the library */
+	if (len == 0 || len >= sizeof(buf)) return -1;
+	for (i = 0; i < len; ++i) {
+		if (!is_digit(s[i]) && s[i] != ':' && s[i] != ';' && s[i] != '.') return -1;
+	}
+	memcpy(buf, s, len);
+	buf[len] = '\0';
+	timecode_parse_time(t, r, buf);
+	return 0;
+}
+
+static int format_int(char *out, int64_t v) {
+	char tmp[24];
+	int n = 0, i = 0;
+	uint64_t u = v < 0 ? -(uint64_t)v : (uint64_t)v;
+	do {
+		tmp[n++] = '0' + u % 10;
+		u /= 10;
+	} while (u > 0);
+	if (v < 0) out[i++] = '-';
+	while (n > 0) out[i++] = tmp[--n];
+	return i;
+}
+
+static int format_tc(char *out, TimecodeTime const * const t, TimecodeKernels const * const k) {
+	k->time_to_string(out, t);
+	return strlen(out);
+}
+
+/*****************************************************************************
+ * commands
+ */
+
+static int c_s2t(Ctx const * const c, const char *s, const size_t len, char *out) {
+	TimecodeTime t;
+	int64_t sample;
+	if (parse_int(s, len, &sample) || sample < 0) return -1;
+	c->k_in->sample_to_time(&t, &c->r_in, c->samplerate, sample);
+	return format_tc(out, &t, c->k_in);
+}
+
+static int c_t2s(Ctx const * const c, const char *s, const size_t len, char *out) {
+	TimecodeTime t;
+	if (parse_tc(s, len, &t, &c->r_in)) return -1;
+	return format_int(out, c->k_in->to_sample(&t, &c->r_in, c->samplerate));
+}
+
+static int c_t2sec(Ctx const * const c, const char *s, const size_t len, char *out) {
+	TimecodeTime t;
+	TimecodeTicks ticks, sec, usec;
+	int i, n;
+	if (parse_tc(s, len, &t, &c->r_in)) return -1;
+	ticks = timecode_time_to_ticks(&t, &c->r_in);
+	sec = ticks / TIMECODE_TICKS_PER_SECOND;
+	usec = ((ticks % TIMECODE_TICKS_PER_SECOND) * 1000000 + TIMECODE_TICKS_PER_SECOND / 2) / TIMECODE_TICKS_PER_SECOND;
+	if (usec == 1000000) {
+		++sec;
+		usec = 0;
+	}
+	n = format_int(out, sec);
+	out[n++] = '.';
+	for (i = 5; i >= 0; --i, usec /= 10) {
+		out[n + i] = '0' + usec % 10;
+	}
+	return n + 6;
+}
+
+static int c_convert(Ctx const * const c, const char *s, const size_t len, char *out) {
+	TimecodeTime t, o;
+	if (parse_tc(s, len, &t, &c->r_in)) return -1;
+	timecode_convert_rate(&o, &c->r_out, &t, &c->r_in);
+	return format_tc(out, &o, c->k_out);
+}
+
+static int c_fmt(Ctx const * const c, const char *s, const size_t len, char *out) {
+	TimecodeTime t;
+	if (parse_tc(s, len, &t, &c->r_in)) return -1;
+	return format_tc(out, &t, c->k_in);
+}
+
+static const struct {
+	const char *name;
+	ConvertFn fn;
+} commands[] = {
+	{ "s2t",     c_s2t },
+	{ "t2s",     c_t2s },
+	{ "t2sec",   c_t2sec },
+	{ "convert", c_convert },
+	{ "fmt",     c_fmt },
+};
+
+/*****************************************************************************
+ * block processing
+ */
+
+static int reserve(Job *j, const size_t n) {
+	if (j->out_len + n <= j->out_size) return 0;
+	size_t sz = j->out_size ? j->out_size : BLOCK_SIZE;
+	while (sz < j->out_len + n) sz *= 2;
+	char *o = realloc(j->out, sz);
+	if (!o) return -1;
+	j->out = o;
+	j->out_size = sz;
+	return 0;
+}
+
+static void *job_run(void *arg) {
+	Job *j = (Job*) arg;
+	const char *p = j->in;
+	const char * const end = j->in + j->len;
+	j->out_len = 0;
+	while (p < end) {
+		const char *eol = memchr(p, '\n', end - p);
+		int n;
+		if (!eol) eol = end;
+		if (reserve(j, MAX_LINE + (eol - p) + 1)) {
+			j->bad = SIZE_MAX;
+			break;
+		}
+		n = j->ctx->convert(j->ctx, p, eol - p, j->out + j->out_len);
+		if (n < 0) {
+			memcpy(j->out + j->out_len, p, eol - p);
+			n = eol - p;
+			++j->bad;
+		}
+		j->out_len += n;
+		j->out[j->out_len++] = '\n';
+		p = eol + 1;
+	}
+	return NULL;
+}
+
+static int write_all(const int fd, const char *buf, size_t len) {
+	while (len > 0) {
+		const ssize_t rv = write(fd, buf, len);
+		if (rv < 0 && errno == EINTR) continue;
+		if (rv <= 0) return -1;
+		buf += rv;
+		len -= rv;
+	}
+	return 0;
+}
+
+/* convert complete lines in buf, split over n_jobs threads, write in order */
+static int process(Job *jobs, const int n_jobs, const char *buf, const size_t len, const int fd) {
+	const char *p = buf;
+	const char * const end = buf + len;
+	int i, n = 0;
+
+	for (i = 0; i < n_jobs && p < end; ++i) {
+		const char *e = p + (len + n_jobs - 1) / n_jobs;
+		if (e >= end) {
+			e = end;
+		} else {
+			e = memchr(e, '\n', end - e);
+			e = e ? e + 1 : end;
+		}
+		jobs[i].in = p;
+		jobs[i].len = e - p;
+		p = e;
+		++n;
+	}
+	if (n == 1) {
+		job_run(&jobs[0]);
+	} else {
+		for (i = 0; i < n; ++i) {
+			if (pthread_create(&jobs[i].thread, NULL, job_run, &jobs[i])) {
+				job_run(&jobs[i]);
+				jobs[i].thread = pthread_self();
+			}
+		}
+		for (i = 0; i < n; ++i) {
+			if (!pthread_equal(jobs[i].thread, pthread_self())) {
+				pthread_join(jobs[i].thread, NULL);
+			}
+		}
+	}
+	for (i = 0; i < n; ++i) {
+		if (jobs[i].bad == SIZE_MAX) return -1;
+		if (write_all(fd, jobs[i].out, jobs[i].out_len)) return -1;
+	}
+	return 0;
+}
+
+static int process_mapped(Job *jobs, const int n_jobs, const int in, const int out) {
+	struct stat st;
+	const char *map;
+	size_t off = 0;
+	int rv = 0;
+
+	if (fstat(in, &st) || !S_ISREG(st.st_mode)) return 1;
+	if (st.st_size == 0) return 0;
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, in, 0);
+	if (map == MAP_FAILED) return 1;
+	madvise((void*)map, st.st_size, MADV_SEQUENTIAL);
+
+	while (off < (size_t)st.st_size && !rv) {
+		size_t len = (size_t)n_jobs * BLOCK_SIZE;
+		if (off + len >= (size_t)st.st_size) {
+			len = st.st_size - off;
+		} else {
+			const char *e = memchr(map + off + len, '\n', st.st_size - off - len);
+			len = e ? (size_t)(e + 1 - (map + off)) : st.st_size - off;
+		}
+		if (process(jobs, n_jobs, map + off, len, out)) rv = -1;
+		off += len;
+	}
+	munmap((void*)map, st.st_size);
+	return rv;
+}
+
+static int process_stream(Job *jobs, const int n_jobs, const int in, const int out) {
+	const size_t size = (size_t)n_jobs * BLOCK_SIZE;
+	char *buf = malloc(size);
+	size_t fill = 0;
+	int eof = 0, rv = 0;
+
+	if (!buf) return -1;
+	while (!eof && !rv) {
+		const char *e;
+		ssize_t n = read(in, buf + fill, size - fill);
+		if (n < 0 && errno == EINTR) continue;
+		if (n < 0) { rv = -1; break; }
+		if (n == 0) eof = 1;
+		fill += n;
+		if (!eof && fill < size) continue;
+
+		/* process complete lines, keep the rest for the next block */
+		for (e = buf + fill; e > buf && e[-1] != '\n'; --e) ;
+		if (eof || e == buf) e = buf + fill;
+		if (e > buf && process(jobs, n_jobs, buf, e - buf, out)) rv = -1;
+		fill = buf + fill - e;
+		memmove(buf, e, fill);
+	}
+	free(buf);
+	return rv;
+}
+
+/*****************************************************************************
+ * main
+ */
+
+static int parse_rate(TimecodeRate *r, const char *name) {
+	TimecodeRateID id = timecode_rate_lookup(name);
+	if (id != TIMECODE_RATE_INVALID) {
+		*r = *timecode_rate_by_id(id);
+		return 0;
+	}
+	if (!is_digit(name[0])) return -1;
+	memset(r, 0, sizeof(TimecodeRate));
+	timecode_parse_framerate(r, name, 1);
+	return r->num > 0 ? 0 : -1;
+}
+
+static void usage(int status) {
+	printf("usage: timecode [-r rate] [-R rate] [-s samplerate] [-j threads] [-o file] <command> [file...]\n"
+	       "commands: s2t t2s t2sec convert fmt\n");
+	exit(status);
+}
+
+int main (int argc, char **argv) {
+	Ctx ctx;
+	Job jobs[MAX_THREADS];
+	const char *outfile = NULL;
+	int c, i, n_jobs = 1, out = 1, rv = 0, out_rate = 0;
+	size_t bad = 0;
+
+	memset(&ctx, 0, sizeof(ctx));
+	memset(jobs, 0, sizeof(jobs));
+	ctx.r_in = *timecode_FPS25;
+	ctx.samplerate = 48000;
+
+	while ((c = getopt(argc, argv, "r:R:s:j:o:hV")) != -1) {
+		switch (c) {
+			case 'r':
+				if (parse_rate(&ctx.r_in, optarg)) {
+					fprintf(stderr, "timecode: invalid rate '%s'\n", optarg);
+					return 1;
+				}
+				break;
+			case 'R':
+				if (parse_rate(&ctx.r_out, optarg)) {
+					fprintf(stderr, "timecode: invalid rate '%s'\n", optarg);
+					return 1;
+				}
+				out_rate = 1;
+				break;
+			case 's': ctx.samplerate = atof(optarg); break;
+			case 'j': n_jobs = atoi(optarg); break;
+			case 'o': outfile = optarg; break;
+#ifdef VERSION
+			case 'V': printf("timecode %s\n", VERSION); return 0;
+#endif
+			case 'h': usage(0); break;
+			default: usage(1);
+		}
+	}
+	if (optind >= argc) usage(1);
+	for (i = 0; i < (int)(sizeof(commands) / sizeof(commands[0])); ++i) {
+		if (!strcmp(argv[optind], commands[i].name)) ctx.convert = commands[i].fn;
+	}
+	if (!ctx.convert || ctx.samplerate <= 0) usage(1);
+	++optind;
+
+	if (!out_rate) ctx.r_out = ctx.r_in;
+	ctx.k_in = timecode_rate_kernels(&ctx.r_in);
+	ctx.k_out = timecode_rate_kernels(&ctx.r_out);
+	if (n_jobs < 1) n_jobs = 1;
+	if (n_jobs > MAX_THREADS) n_jobs = MAX_THREADS;
+	for (i = 0; i < n_jobs; ++i) {
+		jobs[i].ctx = &ctx;
+	}
+
+	if (outfile && (out = open(outfile, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+		fprintf(stderr, "timecode: cannot open '%s': %s\n", outfile, strerror(errno));
+		return 2;
+	}
+
+	if (optind >= argc) {
+		rv = process_mapped(jobs, n_jobs, 0, out);
+		if (rv > 0) rv = process_stream(jobs, n_jobs, 0, out);
+	}
+	for (; optind < argc && !rv; ++optind) {
+		const int in = strcmp(argv[optind], "-") ? open(argv[optind], O_RDONLY) : 0;
+		if (in < 0) {
+			fprintf(stderr, "timecode: cannot open '%s': %s\n", argv[optind], strerror(errno));
+			rv = -1;
+			break;
+		}
+		rv = process_mapped(jobs, n_jobs, in, out);
+		if (rv > 0) rv = process_stream(jobs, n_jobs, in, out);
+		if (in != 0) close(in);
+	}
+
+	if (rv) {
+		fprintf(stderr, "timecode: I/O error\n");
+	}
+	if (out != 1 && close(out)) {
+		rv = -1;
+	}
+	for (i = 0; i < n_jobs; ++i) {
+		bad += jobs[i].bad;
+		free(jobs[i].out);
+	}
+	if (bad > 0) {
+		fprintf(stderr, "timecode: %zu lines could not be converted\n", bad);
+	}
+	return rv ? 2 : 0;
+}